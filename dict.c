@@ -767,6 +767,12 @@ CELL *dictWhere(FICL_DICT *pDict)
 }
 
 
+/*
+** Starts at 1 so that a zero-filled method cache never looks current.
+*/
+FICL_UNS ficlHashEpoch = 1;
+
+
 /**************************************************************************
                         h a s h F o r g e t
 ** Unlink all words in the hash that have addresses greater than or
@@ -793,6 +799,7 @@ void hashForget(FICL_HASH *pHash, const void *where)
         pHash->table[i] = pWord;
     }
 
+    ficlHashEpoch++;
     return;
 }
 
@@ -912,6 +919,7 @@ void hashInsertWord(FICL_HASH *pHash, FICL_WORD *pFW)
 
     pFW->link = *pList;
     *pList = pFW;
+    ficlHashEpoch++;
     return;
 }
 
@@ -970,5 +978,6 @@ void hashReset(FICL_HASH *pHash)
 
     pHash->link = NULL;
     pHash->name = NULL;
+    ficlHashEpoch++;
     return;
 }
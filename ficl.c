@@ -97,6 +97,7 @@ FICL_SYSTEM *ficlInitSystemEx(FICL_SYSTEM_INFO *fsi)
     assert(fsi->size == sizeof (FICL_SYSTEM_INFO));
 
     memset(pSys, 0, sizeof (FICL_SYSTEM));
+    ficlHeapInit(pSys, &fsi->allocator);
 
     nDictCells = fsi->nDictCells;
     if (nDictCells <= 0)
@@ -109,6 +110,12 @@ FICL_SYSTEM *ficlInitSystemEx(FICL_SYSTEM_INFO *fsi)
     pSys->envp->name = "environment-wordlist";
 
     pSys->textOut = (fsi->textOut != NULL) ? fsi->textOut : ficlTextOut;
+    if (fsi->textOutN != NULL)
+        pSys->textOutN = fsi->textOutN;
+    else if (pSys->textOut == ficlTextOut)
+        pSys->textOutN = ficlTextOutN;
+    else
+        pSys->textOutN = NULL;  /* host supplied textOut only - honor it */
     pSys->pExtend = fsi->pExtend;
 
 #if FICL_WANT_LOCALS
@@ -241,11 +248,23 @@ void ficlListParseSteps(FICL_VM *pVM)
 **************************************************************************/
 FICL_VM *ficlNewVM(FICL_SYSTEM *pSys)
 {
-    FICL_VM *pVM = vmCreate(NULL, defaultStack, defaultStack);
+    return ficlNewVMEx(pSys, defaultStack, defaultStack);
+}
+
+
+/**************************************************************************
+                        f i c l N e w V M E x
+** Create a new virtual machine with the specified stack sizes (in cells)
+** and link it into the system list of VMs.
+**************************************************************************/
+FICL_VM *ficlNewVMEx(FICL_SYSTEM *pSys, unsigned nPStack, unsigned nRStack)
+{
+    FICL_VM *pVM = vmCreate(NULL, nPStack, nRStack);
     pVM->link = pSys->vmList;
     pVM->pSys = pSys;
     pVM->pExtend = pSys->pExtend;
     vmSetTextOut(pVM, pSys->textOut);
+    vmSetTextOutN(pVM, pSys->textOutN);
 
     pSys->vmList = pVM;
     return pVM;
@@ -444,10 +463,117 @@ int ficlExecC(FICL_VM *pVM, const char *pText, FICL_INT size)
 
     pVM->pState    = oldState;
     vmPopTib(pVM, &saveTib);
+    vmFlushOutput(pVM);
     return except;
 }
 
 
+/**************************************************************************
+                        f i c l E x e c L i n e s
+** Interprets text a line at a time - see ficl.h
+**************************************************************************/
+size_t ficlExecLines(FICL_VM *pVM, const char *text, size_t len, bool fFinal, int *pResult)
+{
+    const char *cp = text;
+    const char *end = text + len;
+
+    while ((cp != end) && (*pResult == VM_OUTOFTEXT))
+    {
+        const char *eol = (const char *)memchr(cp, '\n', end - cp);
+        size_t n;
+
+        if ((eol == NULL) && !fFinal)
+            break;
+
+        n = (eol ? eol : end) - cp;
+        if ((n > 0) && (cp[n - 1] == '\r'))
+            *pResult = ficlExecC(pVM, cp, (FICL_INT)(n - 1));
+        else
+            *pResult = ficlExecC(pVM, cp, (FICL_INT)n);
+        cp += n + (eol != NULL);
+    }
+
+    return cp - text;
+}
+
+
+/**************************************************************************
+                        f i c l E x e c R e f i l l
+** Interprets text pulled from the VM's refill callback - see ficl.h.
+** The buffer holds one FICL_INCLUDE_CHUNK, and only grows if a single
+** line is longer than that.
+**************************************************************************/
+int ficlExecRefill(FICL_VM *pVM)
+{
+    size_t size = FICL_INCLUDE_CHUNK;
+    size_t start = 0;       /* first unconsumed byte in buffer */
+    size_t end = 0;         /* one past the last byte pulled */
+    bool fEnd = false;
+    int result = VM_OUTOFTEXT;
+    char *buffer = (char *)ficlMalloc(size);
+
+    assert(pVM->refill);
+
+    while (buffer != NULL)
+    {
+        FICL_INT got;
+
+        start += ficlExecLines(pVM, buffer + start, end - start, fEnd, &result);
+        if (fEnd || (result != VM_OUTOFTEXT))
+            break;
+
+        /* out of complete lines: keep the partial one and pull more */
+        memmove(buffer, buffer + start, end - start);
+        end -= start;
+        start = 0;
+
+        if (end == size)
+        {
+            char *bigger = (char *)ficlRealloc(buffer, size * 2);
+            if (bigger == NULL)
+            {
+                ficlFree(buffer);
+                buffer = NULL;
+                break;
+            }
+            buffer = bigger;
+            size *= 2;
+        }
+
+        got = (pVM->refill)(pVM, buffer + end, size - end);
+        if (got < 0)
+        {
+            vmTextOut(pVM, "Error: refill failed", true);
+            result = VM_ERREXIT;
+            break;
+        }
+        end += (size_t)got;
+        fEnd = (got == 0);
+    }
+
+    if (buffer == NULL)
+    {
+        vmTextOut(pVM, "Error: out of memory in ficlExecRefill", true);
+        result = VM_ERREXIT;
+    }
+    ficlFree(buffer);
+
+    /*
+    ** Pass an empty line with SOURCE-ID == -1 to flush
+    ** any pending REFILLs (as required by FILE wordset)
+    */
+    if (result == VM_OUTOFTEXT)
+    {
+        CELL id = pVM->sourceID;
+        pVM->sourceID.i = -1;
+        ficlExec(pVM, "");
+        pVM->sourceID = id;
+    }
+
+    return result;
+}
+
+
 /**************************************************************************
                         f i c l E x e c X T
 ** Given a pointer to a FICL_WORD, push an inner interpreter and
@@ -522,6 +648,7 @@ int ficlExecXT(FICL_VM *pVM, FICL_WORD *pWord)
 
     pVM->pState    = oldState;
     pVM->runningWord = oldRunningWord;
+    vmFlushOutput(pVM);
     return except;
 }
 
@@ -688,6 +815,10 @@ int ficlSetStackSize(int nStackCells)
 **************************************************************************/
 void ficlTermSystem(FICL_SYSTEM *pSys)
 {
+#if FICL_WANT_ASYNC_IO
+    ficlAsyncTerm(pSys);    /* workers may be writing into the dictionary */
+#endif
+
     if (pSys->dp)
         dictDelete(pSys->dp);
     pSys->dp = NULL;
@@ -707,6 +838,7 @@ void ficlTermSystem(FICL_SYSTEM *pSys)
         vmDelete(pVM);
     }
 
+    ficlHeapTerm(pSys);
     ficlFree(pSys);
     pSys = NULL;
     return;
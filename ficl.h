@@ -349,8 +349,33 @@ typedef FICL_WORD ** IPTYPE; /* the VM's instruction pointer */
 ** this makes it possible to have each VM do I/O
 ** through a different device. If you specify no
 ** OUTFUNC, it defaults to ficlTextOut.
+** OUTFUNCN is the length-delimited form: text need not be null
+** terminated, so TYPE and friends can hand over their buffers as-is.
+** A VM with no OUTFUNCN falls back to its OUTFUNC (see vmTextOutN).
 */
 typedef void (*OUTFUNC)(FICL_VM *pVM, const char *text, bool fNewline);
+typedef void (*OUTFUNCN)(FICL_VM *pVM, const char *text, size_t len, bool fNewline);
+
+/*
+** A REFILLFUNC supplies source text on demand for ficlExecRefill: it
+** copies up to size bytes of the next text into buf and returns how
+** many it copied, 0 at the end of the text, or -1 on error. The
+** context passed to vmSetRefill is in pVM->pRefillCtx.
+*/
+typedef FICL_INT (*REFILLFUNC)(FICL_VM *pVM, char *buf, size_t size);
+
+/*
+** While an alloc-mark is active, ALLOCATE bump-allocates from the VM's
+** region instead of the heap, and alloc-release frees everything back
+** to the mark in one step. See heap.c.
+*/
+typedef struct ficl_region_chunk FICL_REGION_CHUNK;
+typedef struct ficl_region
+{
+    FICL_REGION_CHUNK *pChunk;  /* newest chunk - older ones linked behind it */
+    FICL_UNS nMarks;            /* active marks */
+    size_t   marks[FICL_MAX_ALLOC_MARKS]; /* region offset at each mark */
+} FICL_REGION;
 
 /*
 ** Each VM operates in one of two non-error states: interpreting
@@ -391,6 +416,12 @@ struct vm
     FICL_VM        *link;       /* Ficl keeps a VM list for simple teardown */
     FICL_JMP_BUF   *pState;     /* crude exception mechanism...     */
     OUTFUNC         textOut;    /* Output callback - see sysdep.c   */
+    OUTFUNCN        textOutN;   /* length-delimited output callback - NULL to use textOut */
+    REFILLFUNC      refill;     /* source text callback for ficlExecRefill */
+    void           *pRefillCtx; /* for refill's use - see vmSetRefill */
+    char           *outBuf;     /* output waiting for textOut (see vmTextOut) */
+    size_t          outSize;    /* capacity of outBuf - 0 for unbuffered */
+    size_t          outLen;     /* bytes waiting in outBuf */
     void *          pExtend;    /* vm extension pointer for app use - initialized from FICL_SYSTEM */
     bool            fRestart;   /* Set true to restart runningWord - debugger support */
 #if FICL_WANT_INTERRUPT
@@ -405,6 +436,11 @@ struct vm
 #if FICL_WANT_FLOAT
     FICL_UNS        fPrecision; /* number of decimal places for float output */
     FICL_FSTACK    *fStack;     /* float stack (optional)           */
+#endif
+    size_t          arenaBytes; /* size of the block holding this VM and its stacks */
+    FICL_REGION     region;     /* alloc-mark / alloc-release storage */
+#if FICL_WANT_GUARD_PAGES
+    FICL_VM        *guardLink;  /* list of guard-paged VMs for the SIGSEGV handler */
 #endif
     CELL            sourceID;   /* -1 if EVALUATE, 0 if normal input */
     TIB             tib;        /* address of incoming text string  */
@@ -508,6 +544,12 @@ typedef enum
     FICL_OP_OF,
     FICL_OP_LEAVE,
     FICL_OP_UNLOOP,
+    FICL_OP_LOOP_I,
+    FICL_OP_LOOP_J,
+    FICL_OP_LOOP_K,
+    FICL_OP_I_PLUS,
+    FICL_OP_I_CELLS,
+    FICL_OP_I_CELLS_PLUS,
     FICL_OP_COLON,
     FICL_OP_CONSTANT,
     FICL_OP_2CONSTANT,
@@ -519,6 +561,32 @@ typedef enum
 #endif
     FICL_OP_STRINGLIT,
     FICL_OP_CSTRINGLIT,
+#if FICL_WANT_LOCALS
+    FICL_OP_LINK,
+    FICL_OP_UNLINK,
+    FICL_OP_GET_LOCAL,
+    FICL_OP_TO_LOCAL,
+    FICL_OP_GET_LOCAL0,
+    FICL_OP_TO_LOCAL0,
+    FICL_OP_GET_LOCAL1,
+    FICL_OP_TO_LOCAL1,
+    FICL_OP_GET_2LOCAL,
+    FICL_OP_TO_2LOCAL,
+#if FICL_WANT_FLOAT
+    FICL_OP_GET_FLOCAL,
+    FICL_OP_TO_FLOCAL,
+#endif
+#endif
+#if FICL_WANT_OOP
+    FICL_OP_METHOD,
+    FICL_OP_METHOD_XT,
+    FICL_OP_IVAR,
+    FICL_OP_AGGREGATE,
+    FICL_OP_REF,
+#if FICL_WANT_VCALL
+    FICL_OP_VCALL,
+#endif
+#endif
 #if FICL_WANT_FLOAT
     FICL_OP_FCONSTANT,
     FICL_OP_FDUP,
@@ -627,7 +695,10 @@ bool wordIsCompileOnly(FICL_WORD *pFW);
 
 void        vmBranchRelative(FICL_VM *pVM, int offset);
 FICL_VM *   vmCreate       (FICL_VM *pVM, unsigned nPStack, unsigned nRStack);
+bool        vmCheckGuards  (FICL_VM *pVM);
 void        vmDelete       (FICL_VM *pVM);
+void        vmFlushOutput  (FICL_VM *pVM);
+bool        vmSetOutputSize(FICL_VM *pVM, size_t size);
 void        vmExecute      (FICL_VM *pVM, FICL_WORD *pWord);
 FICL_DICT  *vmGetDict      (FICL_VM *pVM);
 char *      vmGetString    (FICL_VM *pVM, FICL_STRING *spDest, char delimiter);
@@ -644,7 +715,10 @@ void        vmQuit         (FICL_VM *pVM);
 void        vmReset        (FICL_VM *pVM);
 void        vmStep         (FICL_VM *pVM);
 void        vmSetTextOut   (FICL_VM *pVM, OUTFUNC textOut);
+void        vmSetTextOutN  (FICL_VM *pVM, OUTFUNCN textOutN);
+void        vmSetRefill    (FICL_VM *pVM, REFILLFUNC refill, void *pCtx);
 void        vmTextOut      (FICL_VM *pVM, const char *text, bool fNewline);
+void        vmTextOutN     (FICL_VM *pVM, const char *text, size_t len, bool fNewline);
 void        vmThrow        (FICL_VM *pVM, int except);
 void        vmThrowErr     (FICL_VM *pVM, const char *fmt, ...);
 void        vmThrowUnderflow(FICL_VM *pVM);
@@ -706,10 +780,38 @@ void        vmPopTib   (FICL_VM *pVM, TIB *pTib);
 */
 char       *ficlLtoa( FICL_INT value, char *string, int radix );
 char       *ficlUltoa(FICL_UNS value, char *string, int radix );
+/*
+** Right-to-left formatters: write the digits of value so that they end
+** just before end and return a pointer to the first one (no NUL).
+** FICL_ULTOA_MAX is the most digits an unsigned cell can need (base 2);
+** leave one more byte for the sign with ficlLtoaEnd.
+*/
+#define FICL_ULTOA_MAX (sizeof(FICL_UNS) * 8)
+char       *ficlUltoaEnd(FICL_UNS value, char *end, int radix);
+char       *ficlLtoaEnd(FICL_INT value, char *end, int radix);
 char        digit_to_char(int value);
 char       *ficlStrrev(char *string );
 const char *skipSpace(const char *cp, const char *end);
 int         strincmp(const char *cp1, const char *cp2, FICL_UNS count);
+/*
+** Memory and string kernels behind MOVE, CMOVE, COMPARE, SEARCH, SKIP...
+** ficlMemCompare returns -1, 0 or 1 like COMPARE.
+*/
+void        ficlCmove(char *dst, const char *src, FICL_UNS u);
+void        ficlCmoveUp(char *dst, const char *src, FICL_UNS u);
+int         ficlMemCompare(const char *cp1, FICL_UNS u1, const char *cp2, FICL_UNS u2, bool fCaseless);
+const char *ficlMemSearch(const char *hay, FICL_UNS uHay, const char *needle, FICL_UNS uNeedle);
+const char *ficlMemSkip(const char *cp, FICL_UNS u, char c);
+/*
+** Cell array kernels behind CELLS-SUM, CELLS-MIN, CELLS-SORT...
+** ficlCellMinMax needs u > 0 and returns the index of the first hit.
+*/
+FICL_INT    ficlCellSum(const FICL_INT *p, FICL_UNS u);
+FICL_UNS    ficlCellMinMax(const FICL_INT *p, FICL_UNS u, bool fMax);
+void        ficlCellPrefixSum(FICL_INT *p, FICL_UNS u);
+FICL_UNS    ficlCellLowerBound(const FICL_INT *p, FICL_UNS u, FICL_INT n);
+FICL_UNS    ficlCellHistogram(const FICL_INT *p, FICL_UNS u, FICL_UNS *counts, FICL_UNS nBins);
+void        ficlCellSort(FICL_INT *p, FICL_UNS u);
 
 
 /*
@@ -737,6 +839,13 @@ typedef struct ficl_hash
 } FICL_HASH;
 #define FICL_HASH_BYTES(nBuckets) (offsetof(FICL_HASH, table) + (nBuckets) * sizeof(FICL_WORD *))
 
+/*
+** ficlHashEpoch is bumped by every change to any wordlist (insert, forget,
+** reset, or a new parent link). Late-bound method caches compare against it
+** so that they never return an xt the wordlists no longer agree with.
+*/
+extern FICL_UNS ficlHashEpoch;
+
 void        hashForget    (FICL_HASH *pHash, const void *where);
 UNS16       hashHashCode  (STRINGINFO si);
 void        hashInsertWord(FICL_HASH *pHash, FICL_WORD *pFW);
@@ -889,6 +998,58 @@ typedef struct FICL_BREAKPOINT
 } FICL_BREAKPOINT;
 
 
+/*
+** F I C L _ A L L O C A T O R
+** The heap behind the MEMORY wordset (ALLOCATE, FREE, RESIZE) - and
+** so behind OO alloc/free and the c-string class. Supply your own in
+** FICL_SYSTEM_INFO, or leave it zeroed to get the default size-class
+** heap in heap.c. resize(pCtx, NULL, n) must act like alloc. term is
+** optional; ficlTermSystem calls it to release anything still allocated.
+*/
+typedef struct ficl_allocator
+{
+    void *(*alloc) (void *pCtx, size_t size);
+    void *(*resize)(void *pCtx, void *p, size_t size);
+    void  (*free)  (void *pCtx, void *p);
+    void  (*term)  (void *pCtx);
+    void  *pCtx;
+} FICL_ALLOCATOR;
+
+/*
+** Statistics kept by the default heap. Index FICL_HEAP_CLASSES of the
+** count arrays is for blocks too big for any size class.
+*/
+#define FICL_HEAP_CLASSES 8     /* 16, 32, ... 2048 bytes */
+typedef struct ficl_heap_stats
+{
+    size_t bytesLive;
+    size_t bytesPeak;
+    size_t nLive [FICL_HEAP_CLASSES + 1];
+    size_t nTotal[FICL_HEAP_CLASSES + 1];
+} FICL_HEAP_STATS;
+
+void        ficlHeapInit  (FICL_SYSTEM *pSys, const FICL_ALLOCATOR *pAllocator);
+void        ficlHeapTerm  (FICL_SYSTEM *pSys);
+void       *ficlHeapAlloc (FICL_SYSTEM *pSys, size_t size);
+void       *ficlHeapResize(FICL_SYSTEM *pSys, void *p, size_t size);
+void        ficlHeapFree  (FICL_SYSTEM *pSys, void *p);
+const FICL_HEAP_STATS *ficlHeapStats(FICL_SYSTEM *pSys);
+
+/*
+** Region (mark/release) allocation - the C side of alloc-mark and
+** alloc-release. ficlAllocMark returns 0 if marks are nested too deep.
+** Releasing a mark also releases any marks taken after it.
+** ficlAllocate/ficlAllocResize/ficlAllocFree are what ALLOCATE, RESIZE
+** and FREE do: use the region while a mark is active, else the system heap.
+*/
+FICL_UNS    ficlAllocMark   (FICL_VM *pVM);
+void        ficlAllocRelease(FICL_VM *pVM, FICL_UNS mark);
+void       *ficlAllocate    (FICL_VM *pVM, size_t size);
+void       *ficlAllocResize (FICL_VM *pVM, void *p, size_t size);
+void        ficlAllocFree   (FICL_VM *pVM, void *p);
+void        ficlRegionDelete(FICL_VM *pVM);
+
+
 /*
 ** F I C L _ S Y S T E M
 ** The top level data structure of the system - ficl_system ties a list of
@@ -899,6 +1060,8 @@ typedef struct FICL_BREAKPOINT
 ** 1. pExtend - user defined to provide context for applications. It is copied
 ** to each VM's pExtend field as that VM is created.
 ** 2. textOut - default text output function for VMs created in this system (ficlTextOut)
+** 3. textOutN - default length-delimited output function (ficlTextOutN). Left
+** NULL when the host supplies only a textOut, so VMs go through that instead.
 */
 struct ficl_system
 {
@@ -913,6 +1076,11 @@ struct ficl_system
     FICL_WORD *pInterp[3]; /* outer interpreter - see ficlCompileCore*/
     FICL_WORD *parseList[FICL_MAX_PARSE_STEPS];
     OUTFUNC    textOut;
+    OUTFUNCN   textOutN;
+#if FICL_WANT_ASYNC_IO
+    struct ficl_aio *pAio;      /* async file I/O - see fileaccess.c */
+#endif
+    FICL_ALLOCATOR allocator;   /* heap for ALLOCATE, FREE, RESIZE */
 
     /*
     ** Cached addresses of IMMEDIATE compilation factors
@@ -940,6 +1108,15 @@ struct ficl_system
     FICL_WORD *pDrop;
     FICL_WORD *pCStringLit;
     FICL_WORD *pStringLit;
+    FICL_WORD *pCells;
+    FICL_WORD *pIPlus;          /* fused I + superinstructions, see ficlParseWord */
+    FICL_WORD *pICells;
+    FICL_WORD *pICellsPlus;
+    CELL *pFuseMark;            /* here after the last word ficlParseWord compiled */
+#if FICL_WANT_OOP && FICL_WANT_VCALL
+    FICL_WORD *pMethodParen;    /* (-->), see vcallComma */
+    FICL_WORD *pVcallParen;
+#endif
 #if FICL_WANT_LOCALS
     FICL_WORD *pGetLocalParen;
     FICL_WORD *pGet2LocalParen;
@@ -968,6 +1145,8 @@ struct ficl_system_info
     int nDictCells;     /* Size of system's Dictionary */
     OUTFUNC textOut;    /* default textOut function */
     void *pExtend;      /* Initializes VM's pExtend pointer - for application use */
+    FICL_ALLOCATOR allocator; /* heap for ALLOCATE etc - leave zeroed for the default */
+    OUTFUNCN textOutN;  /* default length-delimited textOut - see vmTextOutN */
 };
 
 /*
@@ -1039,6 +1218,28 @@ int        ficlExec (FICL_VM *pVM, const char *pText);
 int        ficlExecC(FICL_VM *pVM, const char *pText, FICL_INT nChars);
 int        ficlExecXT(FICL_VM *pVM, FICL_WORD *pWord);
 
+/*
+** f i c l E x e c R e f i l l
+** Interprets text as the VM's refill callback (see vmSetRefill)
+** delivers it, so a script from a pipe, socket or decompressor runs as
+** it arrives instead of being buffered whole. Text is pulled in
+** FICL_INCLUDE_CHUNK pieces and interpreted a line at a time; a line
+** split between pieces is carried over, so tokens are never broken.
+** Each line is the input buffer, so REFILL moves on to the next line
+** (pulling more text if need be). SOURCE-ID is left as you set it,
+** except that a final empty line is interpreted with SOURCE-ID -1 to
+** end any pending REFILL. Stops at the first line that doesn't return
+** VM_OUTOFTEXT and returns that code; VM_ERREXIT if the callback
+** fails or memory runs out.
+**
+** ficlExecLines is the line splitter: it interprets the complete lines
+** in text, and the trailing partial one too if fFinal, stopping early if
+** a line fails (*pResult is then the failing code; set it to
+** VM_OUTOFTEXT first). Returns the number of bytes consumed.
+*/
+int        ficlExecRefill(FICL_VM *pVM);
+size_t     ficlExecLines (FICL_VM *pVM, const char *text, size_t len, bool fFinal, int *pResult);
+
 /*
 ** Create a new VM from the heap, and link it into the system VM list.
 ** Initializes the VM and binds default sized stacks to it. Returns the
@@ -1047,6 +1248,14 @@ int        ficlExecXT(FICL_VM *pVM, FICL_WORD *pWord);
 */
 FICL_VM   *ficlNewVM(FICL_SYSTEM *pSys);
 
+/*
+** Same as ficlNewVM, but sizes the VM's stacks explicitly rather than
+** using the default set by ficlSetStackSize. The VM and its stacks
+** are carved from a single allocation. nPStack sizes both the param
+** and float stacks; nRStack sizes the return stack.
+*/
+FICL_VM   *ficlNewVMEx(FICL_SYSTEM *pSys, unsigned nPStack, unsigned nRStack);
+
 /*
 ** Force deletion of a VM. You do not need to do this
 ** unless you're creating and discarding a lot of VMs.
@@ -1109,6 +1318,7 @@ int        ficlBuild(FICL_SYSTEM *pSys, const char *name, FICL_CODE code, char f
 ** ficlInitSystem - no need to waste dict space by doing it again.
 */
 void       ficlCompileCore(FICL_SYSTEM *pSys);
+void       ficlCompileHeap(FICL_SYSTEM *pSys);
 void       ficlCompilePrefix(FICL_SYSTEM *pSys);
 void       ficlCompileSearch(FICL_SYSTEM *pSys);
 void       ficlCompileSoftCore(FICL_SYSTEM *pSys);
@@ -1116,6 +1326,9 @@ void       ficlCompileTools(FICL_SYSTEM *pSys);
 #if FICL_WANT_FILE
 void       ficlCompileFile(FICL_SYSTEM *pSys);
 #endif
+#if FICL_WANT_ASYNC_IO
+void       ficlAsyncTerm(FICL_SYSTEM *pSys);
+#endif
 #if FICL_WANT_FLOAT
 void       ficlCompileFloat(FICL_SYSTEM *pSys);
 bool       ficlParseFloatNumber( FICL_VM *pVM, STRINGINFO si ); /* float.c */
@@ -1158,6 +1371,12 @@ typedef enum
     QDO,
     STRINGLIT,
     CSTRINGLIT,
+#if FICL_WANT_OOP
+    METHOD,
+#if FICL_WANT_VCALL
+    VCALL,
+#endif
+#endif
 #if FICL_WANT_USER
     USER,
 #endif
@@ -1166,6 +1385,43 @@ typedef enum
 
 WORDKIND   ficlWordClassify(FICL_WORD *pFW);
 
+#if FICL_WANT_OOP
+/*
+** Late-bound method call sites ((-->), (c->) and METHOD words) carry an
+** inline cache: the ficlHashEpoch it was filled in, then two (class, xt)
+** pairs, most recent first. Compiled call sites follow it with the method
+** name as a FICL_STRING.
+*/
+#define FICL_METHOD_CACHE_CELLS 5
+FICL_WORD *ficlLookupMethod(FICL_VM *pVM, CELL *pCache, void *pClass, STRINGINFO si);
+
+/*
+** Class layout (see the metaclass in oo.fr): parent class, method
+** wordlist, vtable (FICL_WANT_VCALL only), payload size.
+** A class address is the body of the class's CREATE word.
+*/
+#define FICL_CLASS_SUPER 0
+#define FICL_CLASS_WID   1
+#define FICL_CLASS_SIZE  (FICL_WANT_VCALL ? 3 : 2)
+
+#if FICL_WANT_VCALL
+/*
+** A vtable is a count, the ficlVtableEpoch its slots were last filled in,
+** then that many xts. END-CLASS builds one per class: slots inherited
+** from the parent keep their numbers (an override replaces the xt in
+** place), new methods are appended in definition order. (vcall) call
+** sites hold a slot number inline; a stale table is refilled by name
+** (see ficlVtableLookup in words.c).
+*/
+#define FICL_CLASS_VTABLE 2
+#define FICL_VTABLE_COUNT 0
+#define FICL_VTABLE_EPOCH 1
+#define FICL_VTABLE_XT    2
+extern FICL_UNS ficlVtableEpoch;
+FICL_WORD *ficlVtableLookup(FICL_VM *pVM, void *pClass, FICL_UNS slot);
+#endif
+#endif
+
 
 
 /*
@@ -1185,6 +1441,12 @@ typedef struct ficlFILE
 {
     FILE *f;
     char filename[256];
+    int fam;        /* FICL_FAM_* bits it was opened with */
+    char *rbuf;     /* read-line buffer (see fileaccess.c) - NULL until first use */
+    size_t rsize;   /* capacity of rbuf */
+    size_t rpos;    /* next unread byte in rbuf */
+    size_t rlen;    /* bytes read into rbuf */
+    int fNoSeek;    /* stream can't seek back (pipe, tty): rbuf holds a line at most */
 } ficlFILE;
 #endif
 
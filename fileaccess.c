@@ -15,6 +15,19 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#if FICL_HAVE_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+#endif
+#if FICL_HAVE_WRITEV
+    #include <sys/uio.h>
+#endif
+#if FICL_HAVE_SENDFILE
+    #include <sys/sendfile.h>
+#endif
+#if FICL_WANT_ASYNC_IO
+    #include <pthread.h>
+#endif
 
 /*
 **
@@ -94,6 +107,10 @@ static void ficlFopen(FICL_VM *pVM, const char *writeMode) /* ( c-addr u fam --
         }
         strcpy(ff->filename, filename);
         ff->f = f;
+        ff->fam = fam;
+        ff->rbuf = NULL;
+        ff->rsize = ff->rpos = ff->rlen = 0;
+        ff->fNoSeek = 0;
         stackPushPtr(pVM->pStack, ff);
 
         fseek(f, 0, SEEK_SET);
@@ -116,9 +133,181 @@ static void ficlCreateFile(FICL_VM *pVM) /* ( c-addr u fam -- fileid ior ) */
 }
 
 
+/*
+** read-line reads ahead into ff->rbuf. As far as the other words are
+** concerned those bytes are still in the file, so anything else that
+** touches the stream calls syncRead first to discard them and seek
+** the stream back to where read-line left off.
+** A stream that can't seek back (a pipe, FIFO or tty) is only ever read
+** up to the end of the current line (see fillRead), and syncRead leaves
+** what's left of that line in rbuf; words that read the stream take it
+** from there first (see takeRead).
+*/
+static void syncRead(ficlFILE *ff)
+{
+    if (ff->fNoSeek)
+        return;
+    if (ff->rlen > ff->rpos)
+        fseek(ff->f, -(long)(ff->rlen - ff->rpos), SEEK_CUR);
+    ff->rpos = ff->rlen = 0;
+}
+
+
+/*
+** Copies up to size unread bytes out of rbuf (only ever left there for
+** a stream that can't seek) and returns how many.
+*/
+static size_t takeRead(ficlFILE *ff, char *buf, size_t size)
+{
+    size_t n = ff->rlen - ff->rpos;
+
+    if (n == 0)
+        return 0;
+    if (n > size)
+        n = size;
+    memcpy(buf, ff->rbuf + ff->rpos, n);
+    ff->rpos += n;
+    return n;
+}
+
+
+/*
+** Reads more of the file into ff->rbuf, first moving any unread bytes
+** to the front (and doubling the buffer if they fill it). Returns 1 if
+** it read something, 0 at end of file, -1 on error with errno set.
+*/
+static int fillRead(ficlFILE *ff)
+{
+    size_t got;
+
+    if (ff->rbuf == NULL)
+    {
+        ff->rbuf = (char *)ficlMalloc(FICL_READLINE_BUF);
+        if (ff->rbuf == NULL)
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+        ff->rsize = FICL_READLINE_BUF;
+        ff->rpos = ff->rlen = 0;
+        ff->fNoSeek = (ftell(ff->f) < 0) || (fseek(ff->f, 0, SEEK_CUR) != 0);
+    }
+
+    if (ff->rpos > 0)
+    {
+        memmove(ff->rbuf, ff->rbuf + ff->rpos, ff->rlen - ff->rpos);
+        ff->rlen -= ff->rpos;
+        ff->rpos = 0;
+    }
+
+    if (ff->rlen == ff->rsize)
+    {
+        char *bigger = (char *)ficlRealloc(ff->rbuf, ff->rsize * 2);
+        if (bigger == NULL)
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+        ff->rbuf = bigger;
+        ff->rsize *= 2;
+    }
+
+    if (ff->fNoSeek)
+    {
+        int c = 0;
+
+        for (got = 0; (c != '\n') && (ff->rlen + got < ff->rsize); got++)
+        {
+            c = getc(ff->f);
+            if (c == EOF)
+                break;
+            ff->rbuf[ff->rlen + got] = (char)c;
+        }
+    }
+    else
+        got = fread(ff->rbuf + ff->rlen, 1, ff->rsize - ff->rlen, ff->f);
+    ff->rlen += got;
+    if (got > 0)
+        return 1;
+    return ferror(ff->f) ? -1 : 0;
+}
+
+
+#if FICL_HAVE_WRITEV || FICL_HAVE_SENDFILE || FICL_WANT_RAW_IO
+/*
+** Words that read or write a file's descriptor directly bracket the
+** transfer with these: fdBegin empties the stream's buffers and puts the
+** descriptor at the stream's position; fdEnd moves the stream to
+** wherever the descriptor got to.
+*/
+static int fdBegin(ficlFILE *ff)
+{
+    long pos;
+
+    syncRead(ff);
+    fflush(ff->f);
+    pos = ftell(ff->f);
+    if (pos >= 0)
+        lseek(fileno(ff->f), pos, SEEK_SET);
+    return fileno(ff->f);
+}
+
+static void fdEnd(ficlFILE *ff)
+{
+    fseek(ff->f, (long)lseek(fileno(ff->f), 0, SEEK_CUR), SEEK_SET);
+}
+#endif
+
+
+#if FICL_WANT_RAW_IO
+/*
+** read or write until length bytes have moved, end of file, or an
+** error (*pOK is then false). Returns the number of bytes moved.
+*/
+static size_t rawTransfer(int fd, char *buf, size_t length, bool fWrite, bool *pOK)
+{
+    size_t done = 0;
+
+    *pOK = true;
+    while (done < length)
+    {
+        ssize_t got;
+
+        if (fWrite)
+            got = write(fd, buf + done, length - done);
+        else
+            got = read(fd, buf + done, length - done);
+
+        if (got < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            *pOK = false;
+            break;
+        }
+        if (got == 0)
+            break;
+        done += (size_t)got;
+    }
+
+    return done;
+}
+
+
+/*
+** Does this transfer take the raw path? (see FICL_WANT_RAW_IO)
+*/
+static bool rawIO(ficlFILE *ff, size_t length)
+{
+    return ((ff->fam & FICL_FAM_BINARY) != 0) && (length >= FICL_RAW_IO_MIN);
+}
+#endif
+
+
 static int closeFiclFILE(ficlFILE *ff) /* ( fileid -- ior ) */
 {
     FILE *f = ff->f;
+    ficlFree(ff->rbuf);
     ficlFree(ff);
     return !fclose(f);
 }
@@ -225,7 +414,10 @@ static void ficlFileStatus(FICL_VM *pVM) /* ( c-addr u -- x ior ) */
 static void ficlFilePosition(FICL_VM *pVM) /* ( fileid -- ud ior ) */
 {
     ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
-    long ud = ftell(ff->f);
+    long ud;
+
+    syncRead(ff);
+    ud = ftell(ff->f);
     stackPushINT(pVM->pStack, ud);
     pushIor(pVM, ud != -1);
 }
@@ -246,46 +438,107 @@ static long fileSize(FILE *f)
 static void ficlFileSize(FICL_VM *pVM) /* ( fileid -- ud ior ) */
 {
     ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
-    long ud = fileSize(ff->f);
+    long ud;
+
+    syncRead(ff);
+    fflush(ff->f);      /* count what's still in the stream's buffer */
+    ud = fileSize(ff->f);
     stackPushINT(pVM->pStack, ud);
     pushIor(pVM, ud != -1);
 }
 
 
 
+#if FICL_HAVE_MMAP
+/*
+** Maps a regular file read-only and interprets it in place, from the
+** current file position on. Returns false, having done nothing, if
+** the file can't be mapped - the caller then reads it instead.
+*/
+static bool includeMapped(FICL_VM *pVM, ficlFILE *ff, int *pResult)
+{
+    struct stat statbuf;
+    long pos = ftell(ff->f);
+    void *base;
+
+    if ((pos < 0) || (fstat(fileno(ff->f), &statbuf) != 0)
+        || !S_ISREG(statbuf.st_mode) || (statbuf.st_size <= pos))
+        return false;
+
+    base = mmap(NULL, (size_t)statbuf.st_size, PROT_READ, MAP_PRIVATE, fileno(ff->f), 0);
+    if (base == MAP_FAILED)
+        return false;
+    (void)posix_madvise(base, (size_t)statbuf.st_size, POSIX_MADV_SEQUENTIAL);
+
+    ficlExecLines(pVM, (const char *)base + pos, (size_t)(statbuf.st_size - pos), true, pResult);
+
+    munmap(base, (size_t)statbuf.st_size);
+    return true;
+}
+#endif
+
+
+/*
+** REFILLFUNC that feeds include-file's chunked path from the stream
+*/
+static FICL_INT fileRefill(FICL_VM *pVM, char *buf, size_t size)
+{
+    ficlFILE *ff = (ficlFILE *)pVM->pRefillCtx;
+    size_t got = takeRead(ff, buf, size);
+
+    got += fread(buf + got, 1, size - got, ff->f);
+    if ((got == 0) && ferror(ff->f))
+        return -1;
+    return (FICL_INT)got;
+}
+
+
+/*
+** include-file never holds the whole file in a buffer of its own.
+** Where it can, it maps the file and interprets the mapping in place
+** (see includeMapped). Otherwise it hands the stream to ficlExecRefill,
+** which reads it FICL_INCLUDE_CHUNK bytes at a time. Either way each
+** line is the input buffer and SOURCE-ID is the fileid. An error in
+** the file stops the include and propagates to the caller.
+*/
 static void ficlIncludeFile(FICL_VM *pVM) /* ( i*x fileid -- j*x ) */
 {
     ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
     CELL id = pVM->sourceID;
-    long currentPosition, totalSize;
-    long size;
-    pVM->sourceID.p = (void *)ff;
+    int result = VM_OUTOFTEXT;
 
-    currentPosition = ftell(ff->f);
-    totalSize = fileSize(ff->f);
-    size = totalSize - currentPosition;
+    syncRead(ff);
+    pVM->sourceID.p = (void *)ff;
 
-    if ((totalSize != -1) && (currentPosition != -1) && (size > 0))
+#if FICL_HAVE_MMAP
+    if (includeMapped(pVM, ff, &result))
     {
-        char *buffer = (char *)ficlMalloc(size);
-        if (buffer != NULL)
+        /*
+        ** Pass an empty line with SOURCE-ID == -1 to flush
+        ** any pending REFILLs (as required by FILE wordset)
+        */
+        if (result == VM_OUTOFTEXT)
         {
-            long got = fread(buffer, 1, size, ff->f);
-            if (got == size)
-                (void)ficlExecC(pVM, buffer, size);
-            ficlFree(buffer);
+            pVM->sourceID.i = -1;
+            ficlExec(pVM, "");
         }
     }
+    else
+#endif
+    {
+        REFILLFUNC savedRefill = pVM->refill;
+        void *savedCtx = pVM->pRefillCtx;
 
-    /*
-    ** Pass an empty line with SOURCE-ID == -1 to flush
-    ** any pending REFILLs (as required by FILE wordset)
-    */
-    pVM->sourceID.i = -1;
-    ficlExec(pVM, "");
+        vmSetRefill(pVM, fileRefill, ff);
+        result = ficlExecRefill(pVM);
+        vmSetRefill(pVM, savedRefill, savedCtx);
+    }
 
     pVM->sourceID = id;
     closeFiclFILE(ff);
+
+    if (result != VM_OUTOFTEXT)
+        vmThrow(pVM, result);
 }
 
 
@@ -294,11 +547,28 @@ static void ficlReadFile(FICL_VM *pVM) /* ( c-addr u1 fileid -- u2 ior ) */
 {
     ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
     int length = stackPopINT(pVM->pStack);
-    void *address = stackPopPtr(pVM->pStack);
+    char *address = (char *)stackPopPtr(pVM->pStack);
     int result;
 
+    syncRead(ff);
+    result = (int)takeRead(ff, address, (size_t)length);
+
+#if FICL_WANT_RAW_IO
+    if (rawIO(ff, (size_t)length))
+    {
+        bool fOK;
+        int fd = fdBegin(ff);
+
+        result += (int)rawTransfer(fd, address + result, (size_t)(length - result), false, &fOK);
+        fdEnd(ff);
+        stackPushINT(pVM->pStack, result);
+        pushIor(pVM, fOK);
+        return;
+    }
+#endif
+
     clearerr(ff->f);
-    result = fread(address, 1, length, ff->f);
+    result += fread(address + result, 1, length - result, ff->f);
 
     stackPushINT(pVM->pStack, result);
     pushIor(pVM, ferror(ff->f) == 0);
@@ -306,41 +576,132 @@ static void ficlReadFile(FICL_VM *pVM) /* ( c-addr u1 fileid -- u2 ior ) */
 
 
 
+/*
+** read-line copies at most u1 characters of the next line out of the
+** file's read buffer, finding the end of the line with memchr. If the
+** line is longer than u1, the rest of it comes back from the next
+** read-line (so u2 = u1 means the line may have been cut short).
+** Both \n and \r\n end a line, even when the \r and \n straddle reads.
+*/
 static void ficlReadLine(FICL_VM *pVM) /* ( c-addr u1 fileid -- u2 flag ior ) */
 {
     ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
-    int length = stackPopINT(pVM->pStack);
+    size_t length = (size_t)stackPopINT(pVM->pStack);
     char *address = (char *)stackPopPtr(pVM->pStack);
-    int error;
-    int flag;
+    size_t n = 0;
+    bool fAny = false;
+    bool fEnded = false;
+    int status = 1;
 
     clearerr(ff->f);
-    *address = 0;
-    if (fgets(address, length, ff->f) == NULL)
+    if (ff->rbuf == NULL)
+        status = fillRead(ff);
+
+    while (status > 0)
     {
-        error = ferror(ff->f);
-        stackPushINT(pVM->pStack, -1);
+        const char *cp = ff->rbuf + ff->rpos;
+        size_t avail = ff->rlen - ff->rpos;
+        const char *eol = (const char *)memchr(cp, '\n', avail);
+        size_t take = eol ? (size_t)(eol - cp) : avail;
+
+        if (take > length - n)
+            take = length - n;
+        memcpy(address + n, cp, take);
+        n += take;
+        ff->rpos += take;
+        fAny = fAny || (avail > 0);
+
+        if ((take < avail) && (ff->rbuf[ff->rpos] == '\n'))
+        {
+            ff->rpos++;
+            fEnded = true;
+            break;
+        }
+        if (n == length)
+            break;
+
+        status = fillRead(ff);
+    }
+
+    /*
+    ** A CR LF that straddles u1: look past the CR for its LF, so the CR
+    ** is not returned as data and the LF does not read as an empty line
+    */
+    if (!fEnded && (status > 0) && (n > 0) && (address[n - 1] == '\r'))
+    {
+        if (ff->rpos == ff->rlen)
+            status = fillRead(ff);
+        if ((status > 0) && (ff->rbuf[ff->rpos] == '\n'))
+        {
+            ff->rpos++;
+            fEnded = true;
+        }
+    }
+
+    if (status < 0)
+    {
+        stackPushINT(pVM->pStack, 0);
         stackPushINT(pVM->pStack, 0);
-        stackPushINT(pVM->pStack, error);
+        pushIor(pVM, false);
         return;
     }
 
-    error = ferror(ff->f);
-    if (error != 0)
+    if ((fEnded || (status == 0)) && (n > 0) && (address[n - 1] == '\r'))
+        n--;
+
+    stackPushINT(pVM->pStack, (FICL_INT)n);
+    stackPushINT(pVM->pStack, FICL_BOOL(fAny));
+    stackPushINT(pVM->pStack, 0); /* ior */
+}
+
+
+
+/*
+** read-line-ref ( fileid -- c-addr u flag ior )
+** Ficl extension: like read-line, but returns the line where it lies in
+** the file's read buffer instead of copying it, so there is no length
+** limit. c-addr u is valid until the next operation on fileid.
+*/
+static void ficlReadLineRef(FICL_VM *pVM) /* ( fileid -- c-addr u flag ior ) */
+{
+    ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
+    const char *eol = NULL;
+    const char *line;
+    size_t scanned = 0;
+    size_t n;
+    int status = 1;
+
+    clearerr(ff->f);
+    if (ff->rbuf == NULL)
+        status = fillRead(ff);
+
+    while (status > 0)
     {
-        stackPushINT(pVM->pStack, -1);
+        size_t avail = ff->rlen - ff->rpos;
+
+        eol = (const char *)memchr(ff->rbuf + ff->rpos + scanned, '\n', avail - scanned);
+        if (eol != NULL)
+            break;
+        scanned = avail;
+        status = fillRead(ff);
+    }
+
+    if (status < 0)
+    {
+        stackPushPtr(pVM->pStack, NULL);
         stackPushINT(pVM->pStack, 0);
-        stackPushINT(pVM->pStack, error);
+        stackPushINT(pVM->pStack, 0);
+        pushIor(pVM, false);
         return;
     }
 
-    length = strlen(address);
-    flag = (length > 0);
-    if (length && ((address[length - 1] == '\r') || (address[length - 1] == '\n')))
-        length--;
+    line = ff->rbuf + ff->rpos;
+    n = eol ? (size_t)(eol - line) : ff->rlen - ff->rpos;
+    ff->rpos += n + (eol != NULL);
 
-    stackPushINT(pVM->pStack, length);
-    stackPushINT(pVM->pStack, flag);
+    stackPushPtr(pVM->pStack, (void *)line);
+    stackPushINT(pVM->pStack, (FICL_INT)(((n > 0) && (line[n - 1] == '\r')) ? n - 1 : n));
+    stackPushINT(pVM->pStack, FICL_BOOL((eol != NULL) || (n > 0)));
     stackPushINT(pVM->pStack, 0); /* ior */
 }
 
@@ -352,6 +713,20 @@ static void ficlWriteFile(FICL_VM *pVM) /* ( c-addr u1 fileid -- ior ) */
     int length = stackPopINT(pVM->pStack);
     void *address = stackPopPtr(pVM->pStack);
 
+#if FICL_WANT_RAW_IO
+    if (rawIO(ff, (size_t)length))
+    {
+        bool fOK;
+        int fd = fdBegin(ff);
+
+        rawTransfer(fd, (char *)address, (size_t)length, true, &fOK);
+        fdEnd(ff);
+        pushIor(pVM, fOK);
+        return;
+    }
+#endif
+
+    syncRead(ff);
     clearerr(ff->f);
     fwrite(address, 1, length, ff->f);
     pushIor(pVM, ferror(ff->f) == 0);
@@ -365,6 +740,7 @@ static void ficlWriteLine(FICL_VM *pVM) /* ( c-addr u1 fileid -- ior ) */
     size_t length = (size_t)stackPopINT(pVM->pStack);
     void *address = stackPopPtr(pVM->pStack);
 
+    syncRead(ff);
     clearerr(ff->f);
     if (fwrite(address, 1, length, ff->f) == length)
         fwrite("\n", 1, 1, ff->f);
@@ -373,11 +749,185 @@ static void ficlWriteLine(FICL_VM *pVM) /* ( c-addr u1 fileid -- ior ) */
 
 
 
+#if FICL_HAVE_WRITEV
+/*
+** writev until all of iov is written - writev may stop short
+*/
+static bool writevAll(int fd, struct iovec *iov, int count)
+{
+    while (count > 0)
+    {
+        ssize_t got = writev(fd, iov, count);
+        if (got < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        while ((count > 0) && ((size_t)got >= iov->iov_len))
+        {
+            got -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + got;
+            iov->iov_len -= got;
+        }
+    }
+
+    return true;
+}
+#endif
+
+
+/*
+** write-filev ( addr1 u1 ... addrn un n fileid -- ior )
+** Ficl extension: writes n pieces of memory to the file, in order, as
+** if by n WRITE-FILEs. Where the OS has writev they go out in one call
+** (or one per FICL_IOV_BATCH pieces) instead of through the stream.
+*/
+#define FICL_IOV_BATCH 64
+
+static void ficlWriteFileV(FICL_VM *pVM) /* ( addr1 u1 ... addrn un n fileid -- ior ) */
+{
+    ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
+    FICL_INT n = stackPopINT(pVM->pStack);
+    CELL *pPiece;
+    bool fOK = true;
+    FICL_INT i;
+
+    if (n <= 0)
+    {
+        stackPushINT(pVM->pStack, (n == 0) ? 0 : EINVAL);
+        return;
+    }
+
+    vmCheckStack(pVM, (int)(2 * n), 0);
+    pPiece = pVM->pStack->sp - 2 * n;
+
+#if FICL_HAVE_WRITEV
+    {
+        struct iovec iov[FICL_IOV_BATCH];
+        int fd = fdBegin(ff);
+
+        for (i = 0; fOK && (i < n); )
+        {
+            int count = 0;
+
+            for ( ; (count < FICL_IOV_BATCH) && (i < n); count++, i++)
+            {
+                iov[count].iov_base = pPiece[2 * i].p;
+                iov[count].iov_len  = (size_t)pPiece[2 * i + 1].u;
+            }
+            fOK = writevAll(fd, iov, count);
+        }
+
+        fdEnd(ff);
+    }
+#else
+    syncRead(ff);
+    clearerr(ff->f);
+    for (i = 0; fOK && (i < n); i++)
+    {
+        size_t length = (size_t)pPiece[2 * i + 1].u;
+        fOK = (fwrite(pPiece[2 * i].p, 1, length, ff->f) == length);
+    }
+#endif
+
+    stackDrop(pVM->pStack, (int)(2 * n));
+    pushIor(pVM, fOK);
+}
+
+
+
+/*
+** copy-file-range ( fileid-src u-off u fileid-dst -- u2 ior )
+** Ficl extension: copies up to u bytes of fileid-src, starting at
+** offset u-off, to fileid-dst at its current position. u2 is the number
+** of bytes copied (less than u if the source ends first). The source's
+** file position doesn't change. Where the OS has sendfile the data
+** never leaves the kernel; otherwise it goes through a C buffer.
+*/
+static void ficlCopyFileRange(FICL_VM *pVM) /* ( fileid-src u-off u fileid-dst -- u2 ior ) */
+{
+    ficlFILE *dst = (ficlFILE *)stackPopPtr(pVM->pStack);
+    size_t length = (size_t)stackPopINT(pVM->pStack);
+    long offset = (long)stackPopINT(pVM->pStack);
+    ficlFILE *src = (ficlFILE *)stackPopPtr(pVM->pStack);
+    size_t copied = 0;
+    bool fOK = true;
+
+    syncRead(src);
+    fflush(src->f);
+
+#if FICL_HAVE_SENDFILE
+    {
+        int fd = fdBegin(dst);
+        off_t from = (off_t)offset;
+
+        while (copied < length)
+        {
+            ssize_t got = sendfile(fd, fileno(src->f), &from, length - copied);
+            if (got < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                fOK = false;
+                break;
+            }
+            if (got == 0)
+                break;  /* end of source */
+            copied += (size_t)got;
+        }
+
+        fdEnd(dst);
+    }
+#else
+    {
+        char buffer[8192];
+        long here = ftell(src->f);
+
+        syncRead(dst);
+        clearerr(src->f);
+        clearerr(dst->f);
+        fOK = (fseek(src->f, offset, SEEK_SET) == 0);
+        while (fOK && (copied < length))
+        {
+            size_t want = length - copied;
+            size_t got;
+
+            if (want > sizeof (buffer))
+                want = sizeof (buffer);
+            got = fread(buffer, 1, want, src->f);
+            if (got == 0)
+            {
+                fOK = (ferror(src->f) == 0);
+                break;
+            }
+            fOK = (fwrite(buffer, 1, got, dst->f) == got);
+            if (fOK)
+                copied += got;
+        }
+
+        fseek(src->f, here, SEEK_SET);
+    }
+#endif
+
+    stackPushINT(pVM->pStack, (FICL_INT)copied);
+    pushIor(pVM, fOK);
+}
+
+
+
 static void ficlRepositionFile(FICL_VM *pVM) /* ( ud fileid -- ior ) */
 {
     ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
     size_t ud = (size_t)stackPopINT(pVM->pStack);
 
+    syncRead(ff);
     pushIor(pVM, fseek(ff->f, ud, SEEK_SET) == 0);
 }
 
@@ -386,11 +936,473 @@ static void ficlRepositionFile(FICL_VM *pVM) /* ( ud fileid -- ior ) */
 static void ficlFlushFile(FICL_VM *pVM) /* ( fileid -- ior ) */
 {
     ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
+    syncRead(ff);
     pushIor(pVM, fflush(ff->f) == 0);
 }
 
 
 
+#if FICL_HAVE_MMAP
+
+/*
+** map-file ( c-addr u fam -- addr len ior )
+** Ficl extension: maps the whole of the named file into memory, so a
+** script can work on it in place with @, C@, MOVE and friends. With
+** r/o the mapping is private and read-only; with w/o or r/w it is
+** shared and writable, and stores go back to the file (see
+** sync-mapped). An empty file maps as 0 0 with ior 0.
+*/
+static void ficlMapFile(FICL_VM *pVM) /* ( c-addr u fam -- addr len ior ) */
+{
+    int fam = stackPopINT(pVM->pStack);
+    int length = stackPopINT(pVM->pStack);
+    void *address = stackPopPtr(pVM->pStack);
+    bool fWrite = (fam & FICL_FAM_WRITE) != 0;
+    struct stat statbuf;
+    void *base = NULL;
+    size_t size = 0;
+    int ior;
+    int fd;
+
+    char *filename = (char *)ficlMalloc(length + 1);
+    if (filename == NULL)
+    {
+        stackPushPtr(pVM->pStack, NULL);
+        stackPushINT(pVM->pStack, 0);
+        stackPushINT(pVM->pStack, ENOMEM);
+        return;
+    }
+    memcpy(filename, address, length);
+    filename[length] = 0;
+
+    if (FICL_FAM_OPEN_MODE(fam) == 0)
+    {
+        ficlFree(filename);
+        stackPushPtr(pVM->pStack, NULL);
+        stackPushINT(pVM->pStack, 0);
+        stackPushINT(pVM->pStack, EINVAL);
+        return;
+    }
+
+    fd = open(filename, fWrite ? O_RDWR : O_RDONLY);
+    ficlFree(filename);
+
+    if ((fd != -1) && (fstat(fd, &statbuf) == 0))
+    {
+        size = (size_t)statbuf.st_size;
+        ior = 0;
+        if (size > 0)
+        {
+            base = mmap(NULL, size,
+                        fWrite ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                        fWrite ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+            if (base == MAP_FAILED)
+            {
+                ior = errno;
+                base = NULL;
+                size = 0;
+            }
+        }
+    }
+    else
+        ior = errno;
+
+    if (fd != -1)
+        close(fd);  /* the mapping keeps its own reference to the file */
+
+    stackPushPtr(pVM->pStack, base);
+    stackPushINT(pVM->pStack, (FICL_INT)size);
+    stackPushINT(pVM->pStack, ior);
+}
+
+
+/*
+** Rounds addr down to a page boundary (and grows len to match), as
+** munmap and msync require.
+*/
+static void *pageAlign(void *addr, size_t *pLen)
+{
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t offset = (size_t)addr % pageSize;
+
+    *pLen += offset;
+    return (char *)addr - offset;
+}
+
+
+/*
+** unmap-file ( addr len -- ior )
+** Ficl extension: releases a mapping made by map-file
+*/
+static void ficlUnmapFile(FICL_VM *pVM) /* ( addr len -- ior ) */
+{
+    size_t len = (size_t)stackPopINT(pVM->pStack);
+    void *addr = stackPopPtr(pVM->pStack);
+
+    if (len == 0)
+    {
+        stackPushINT(pVM->pStack, 0);
+        return;
+    }
+
+    addr = pageAlign(addr, &len);
+    pushIor(pVM, munmap(addr, len) == 0);
+}
+
+
+/*
+** sync-mapped ( addr len -- ior )
+** Ficl extension: writes stores to (part of) a writable mapping back
+** to its file, and waits for the write to finish
+*/
+static void ficlSyncMapped(FICL_VM *pVM) /* ( addr len -- ior ) */
+{
+    size_t len = (size_t)stackPopINT(pVM->pStack);
+    void *addr = stackPopPtr(pVM->pStack);
+
+    if (len == 0)
+    {
+        stackPushINT(pVM->pStack, 0);
+        return;
+    }
+
+    addr = pageAlign(addr, &len);
+    pushIor(pVM, msync(addr, len, MS_SYNC) == 0);
+}
+
+#endif /* FICL_HAVE_MMAP */
+
+#if FICL_WANT_ASYNC_IO
+/**************************************************************************
+                        A s y n c   I / O
+** read-file-async and write-file-async queue a request and return its
+** id at once. A pool of FICL_AIO_THREADS worker threads (started the
+** first time a system queues a request) carries the requests out with
+** pread/pwrite, so they use an explicit offset and leave the file
+** position alone. io-poll and io-wait collect completed requests; each
+** VM only sees its own. The buffer must stay put, and the file open,
+** until the request has been collected.
+** If the workers can't be started, requests complete before
+** read-file-async/write-file-async return.
+**************************************************************************/
+typedef struct ficl_aio_req
+{
+    struct ficl_aio_req *link;
+    FICL_VM *pVM;       /* whose request this is */
+    FICL_UNS id;
+    bool fWrite;
+    bool fStarted;      /* a worker has taken it */
+    bool fDone;
+    int fd;
+    char *buf;
+    size_t len;
+    off_t off;
+    size_t result;      /* bytes transferred */
+    int ior;
+} FICL_AIO_REQ;
+
+typedef struct ficl_aio
+{
+    pthread_mutex_t lock;
+    pthread_cond_t work;    /* a request was queued, or fStop was set */
+    pthread_cond_t done;    /* a request completed */
+    pthread_t threads[FICL_AIO_THREADS];
+    int nThreads;
+    bool fStop;
+    FICL_UNS lastId;
+    FICL_AIO_REQ *pReqs;    /* all uncollected requests, oldest first */
+} FICL_AIO;
+
+
+static void aioPerform(FICL_AIO_REQ *pReq)
+{
+    while (pReq->result < pReq->len)
+    {
+        ssize_t got;
+        char *cp = pReq->buf + pReq->result;
+        size_t want = pReq->len - pReq->result;
+        off_t off = pReq->off + (off_t)pReq->result;
+
+        if (pReq->fWrite)
+            got = pwrite(pReq->fd, cp, want, off);
+        else
+            got = pread(pReq->fd, cp, want, off);
+
+        if (got < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            pReq->ior = errno;
+            break;
+        }
+        if (got == 0)
+            break;      /* end of file */
+        pReq->result += (size_t)got;
+    }
+}
+
+
+static void *aioWorker(void *p)
+{
+    FICL_AIO *pAio = (FICL_AIO *)p;
+
+    pthread_mutex_lock(&pAio->lock);
+    for (;;)
+    {
+        FICL_AIO_REQ *pReq;
+
+        for (pReq = pAio->pReqs; pReq && pReq->fStarted; pReq = pReq->link)
+            ;
+        if (pAio->fStop)
+            break;
+        if (pReq == NULL)
+        {
+            pthread_cond_wait(&pAio->work, &pAio->lock);
+            continue;
+        }
+
+        pReq->fStarted = true;
+        pthread_mutex_unlock(&pAio->lock);
+        aioPerform(pReq);
+        pthread_mutex_lock(&pAio->lock);
+        pReq->fDone = true;
+        pthread_cond_broadcast(&pAio->done);
+    }
+    pthread_mutex_unlock(&pAio->lock);
+
+    return NULL;
+}
+
+
+static FICL_AIO *aioGet(FICL_SYSTEM *pSys)
+{
+    FICL_AIO *pAio = pSys->pAio;
+    int i;
+
+    if (pAio != NULL)
+        return pAio;
+
+    pAio = (FICL_AIO *)ficlMalloc(sizeof (FICL_AIO));
+    if (pAio == NULL)
+        return NULL;
+    memset(pAio, 0, sizeof (FICL_AIO));
+    pthread_mutex_init(&pAio->lock, NULL);
+    pthread_cond_init(&pAio->work, NULL);
+    pthread_cond_init(&pAio->done, NULL);
+
+    for (i = 0; i < FICL_AIO_THREADS; i++)
+    {
+        if (pthread_create(&pAio->threads[pAio->nThreads], NULL, aioWorker, pAio) == 0)
+            pAio->nThreads++;
+    }
+
+    pSys->pAio = pAio;
+    return pAio;
+}
+
+
+/*
+** Stops the workers (letting any request in progress finish) and
+** frees all uncollected requests. Called by ficlTermSystem.
+*/
+void ficlAsyncTerm(FICL_SYSTEM *pSys)
+{
+    FICL_AIO *pAio = pSys->pAio;
+    int i;
+
+    if (pAio == NULL)
+        return;
+
+    pthread_mutex_lock(&pAio->lock);
+    pAio->fStop = true;
+    pthread_cond_broadcast(&pAio->work);
+    pthread_mutex_unlock(&pAio->lock);
+
+    for (i = 0; i < pAio->nThreads; i++)
+        pthread_join(pAio->threads[i], NULL);
+
+    while (pAio->pReqs != NULL)
+    {
+        FICL_AIO_REQ *pReq = pAio->pReqs;
+        pAio->pReqs = pReq->link;
+        ficlFree(pReq);
+    }
+
+    pthread_cond_destroy(&pAio->done);
+    pthread_cond_destroy(&pAio->work);
+    pthread_mutex_destroy(&pAio->lock);
+    ficlFree(pAio);
+    pSys->pAio = NULL;
+}
+
+
+static void aioSubmit(FICL_VM *pVM, bool fWrite) /* ( c-addr u u-off fileid -- id ior ) */
+{
+    ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
+    off_t off = (off_t)stackPopINT(pVM->pStack);
+    size_t len = (size_t)stackPopINT(pVM->pStack);
+    char *buf = (char *)stackPopPtr(pVM->pStack);
+    FICL_AIO *pAio = aioGet(pVM->pSys);
+    FICL_AIO_REQ *pReq = NULL;
+    FICL_AIO_REQ **ppLink;
+
+    if (pAio != NULL)
+        pReq = (FICL_AIO_REQ *)ficlMalloc(sizeof (FICL_AIO_REQ));
+    if (pReq == NULL)
+    {
+        stackPushINT(pVM->pStack, 0);
+        stackPushINT(pVM->pStack, ENOMEM);
+        return;
+    }
+
+    /* the request works on the descriptor - bring it up to date */
+    syncRead(ff);
+    fflush(ff->f);
+
+    memset(pReq, 0, sizeof (FICL_AIO_REQ));
+    pReq->pVM = pVM;
+    pReq->fWrite = fWrite;
+    pReq->fd = fileno(ff->f);
+    pReq->buf = buf;
+    pReq->len = len;
+    pReq->off = off;
+
+    pthread_mutex_lock(&pAio->lock);
+    pReq->id = ++pAio->lastId;
+    for (ppLink = &pAio->pReqs; *ppLink != NULL; ppLink = &(*ppLink)->link)
+        ;
+    *ppLink = pReq;
+
+    if (pAio->nThreads == 0)
+    {
+        pReq->fStarted = true;
+        aioPerform(pReq);
+        pReq->fDone = true;
+    }
+    else
+        pthread_cond_signal(&pAio->work);
+    pthread_mutex_unlock(&pAio->lock);
+
+    stackPushUNS(pVM->pStack, pReq->id);
+    stackPushINT(pVM->pStack, 0);
+}
+
+
+/*
+** read-file-async ( c-addr u u-off fileid -- id ior )
+** Ficl extension: queues a read of u bytes at offset u-off of the file
+** into c-addr. Collect the result (u2 ior, as for READ-FILE) with
+** io-wait or io-poll.
+*/
+static void ficlReadFileAsync(FICL_VM *pVM)
+{
+    aioSubmit(pVM, false);
+}
+
+
+/*
+** write-file-async ( c-addr u u-off fileid -- id ior )
+** Ficl extension: queues a write of u bytes from c-addr at offset
+** u-off of the file. Collect the result (u2 ior) with io-wait or io-poll.
+*/
+static void ficlWriteFileAsync(FICL_VM *pVM)
+{
+    aioSubmit(pVM, true);
+}
+
+
+/*
+** Unlinks and frees a completed request, pushing u2 ior.
+** Call with the lock held.
+*/
+static void aioCollect(FICL_VM *pVM, FICL_AIO *pAio, FICL_AIO_REQ *pReq)
+{
+    FICL_AIO_REQ **ppLink;
+
+    for (ppLink = &pAio->pReqs; *ppLink != pReq; ppLink = &(*ppLink)->link)
+        ;
+    *ppLink = pReq->link;
+
+    stackPushINT(pVM->pStack, (FICL_INT)pReq->result);
+    stackPushINT(pVM->pStack, pReq->ior);
+    ficlFree(pReq);
+}
+
+
+/*
+** io-poll ( -- id u2 ior true | false )
+** Ficl extension: collects one of this VM's completed requests, if any,
+** without waiting.
+*/
+static void ficlIoPoll(FICL_VM *pVM)
+{
+    FICL_AIO *pAio = pVM->pSys->pAio;
+    FICL_AIO_REQ *pReq;
+
+    if (pAio == NULL)
+    {
+        stackPushINT(pVM->pStack, FICL_FALSE);
+        return;
+    }
+
+    pthread_mutex_lock(&pAio->lock);
+    for (pReq = pAio->pReqs; pReq != NULL; pReq = pReq->link)
+    {
+        if ((pReq->pVM == pVM) && pReq->fDone)
+            break;
+    }
+
+    if (pReq == NULL)
+        stackPushINT(pVM->pStack, FICL_FALSE);
+    else
+    {
+        stackPushUNS(pVM->pStack, pReq->id);
+        aioCollect(pVM, pAio, pReq);
+        stackPushINT(pVM->pStack, FICL_TRUE);
+    }
+    pthread_mutex_unlock(&pAio->lock);
+}
+
+
+/*
+** io-wait ( id -- u2 ior )
+** Ficl extension: waits for the request to complete and collects it.
+** An id that isn't one of this VM's outstanding requests gives 0 EINVAL.
+*/
+static void ficlIoWait(FICL_VM *pVM)
+{
+    FICL_UNS id = stackPopUNS(pVM->pStack);
+    FICL_AIO *pAio = pVM->pSys->pAio;
+    FICL_AIO_REQ *pReq = NULL;
+
+    if (pAio != NULL)
+    {
+        pthread_mutex_lock(&pAio->lock);
+        for (pReq = pAio->pReqs; pReq != NULL; pReq = pReq->link)
+        {
+            if ((pReq->pVM == pVM) && (pReq->id == id))
+                break;
+        }
+
+        if (pReq != NULL)
+        {
+            while (!pReq->fDone)
+                pthread_cond_wait(&pAio->done, &pAio->lock);
+            aioCollect(pVM, pAio, pReq);
+        }
+        pthread_mutex_unlock(&pAio->lock);
+    }
+
+    if (pReq == NULL)
+    {
+        stackPushINT(pVM->pStack, 0);
+        stackPushINT(pVM->pStack, EINVAL);
+    }
+}
+
+#endif /* FICL_WANT_ASYNC_IO */
+
+
 #if FICL_HAVE_FTRUNCATE
 
 static void ficlResizeFile(FICL_VM *pVM) /* ( ud fileid -- ior ) */
@@ -398,6 +1410,8 @@ static void ficlResizeFile(FICL_VM *pVM) /* ( ud fileid -- ior ) */
     ficlFILE *ff = (ficlFILE *)stackPopPtr(pVM->pStack);
     size_t ud = (size_t)stackPopINT(pVM->pStack);
 
+    syncRead(ff);
+    fflush(ff->f);
     pushIor(pVM, ftruncate(fileno(ff->f), ud) == 0);
 }
 
@@ -414,8 +1428,17 @@ void ficlCompileFile(FICL_SYSTEM *pSys)
     dictAppendWord(dp, "include-file", ficlIncludeFile,  FW_DEFAULT);
     dictAppendWord(dp, "read-file", ficlReadFile,  FW_DEFAULT);
     dictAppendWord(dp, "read-line", ficlReadLine,  FW_DEFAULT);
+    dictAppendWord(dp, "read-line-ref", ficlReadLineRef,  FW_DEFAULT);
     dictAppendWord(dp, "write-file", ficlWriteFile,  FW_DEFAULT);
     dictAppendWord(dp, "write-line", ficlWriteLine,  FW_DEFAULT);
+    dictAppendWord(dp, "write-filev", ficlWriteFileV,  FW_DEFAULT);
+    dictAppendWord(dp, "copy-file-range", ficlCopyFileRange,  FW_DEFAULT);
+#if FICL_WANT_ASYNC_IO
+    dictAppendWord(dp, "read-file-async", ficlReadFileAsync,  FW_DEFAULT);
+    dictAppendWord(dp, "write-file-async", ficlWriteFileAsync,  FW_DEFAULT);
+    dictAppendWord(dp, "io-poll", ficlIoPoll,  FW_DEFAULT);
+    dictAppendWord(dp, "io-wait", ficlIoWait,  FW_DEFAULT);
+#endif
     dictAppendWord(dp, "file-position", ficlFilePosition,  FW_DEFAULT);
     dictAppendWord(dp, "file-size", ficlFileSize,  FW_DEFAULT);
     dictAppendWord(dp, "reposition-file", ficlRepositionFile,  FW_DEFAULT);
@@ -425,6 +1448,12 @@ void ficlCompileFile(FICL_SYSTEM *pSys)
     dictAppendWord(dp, "delete-file", ficlDeleteFile,  FW_DEFAULT);
     dictAppendWord(dp, "rename-file", ficlRenameFile,  FW_DEFAULT);
 
+#if FICL_HAVE_MMAP
+    dictAppendWord(dp, "map-file", ficlMapFile,  FW_DEFAULT);
+    dictAppendWord(dp, "unmap-file", ficlUnmapFile,  FW_DEFAULT);
+    dictAppendWord(dp, "sync-mapped", ficlSyncMapped,  FW_DEFAULT);
+#endif
+
 #ifdef FICL_HAVE_FTRUNCATE
     dictAppendWord(dp, "resize-file", ficlResizeFile,  FW_DEFAULT);
 
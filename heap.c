@@ -0,0 +1,705 @@
+/*******************************************************************
+** h e a p . c
+** Forth Inspired Command Language
+** Default heap for the MEMORY wordset (ALLOCATE, FREE, RESIZE)
+** Created: October 2026
+*******************************************************************/
+/*
+** Get the latest Ficl release at https://sourceforge.net/projects/ficl/
+**
+** I am interested in hearing from anyone who uses ficl. If you have
+** a problem, a success story, a bug or bugfix, a suggestion, or
+** if you would like to contribute to Ficl, please contact me on sourceforge.
+**
+** L I C E N S E  and  D I S C L A I M E R
+**
+** Copyright (c) 1997-2026 John W Sadler
+** All rights reserved.
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. Neither the name of the copyright holder nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+** ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+** OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+** HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+** LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+** OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+** SUCH DAMAGE.
+*/
+#include <stdio.h>
+#include <string.h>
+#include "ficl.h"
+
+/*
+** The MEMORY wordset (and so OO alloc/free and the c-string class) gets
+** its storage from the system's FICL_ALLOCATOR. Unless the host supplies
+** one in FICL_SYSTEM_INFO, that is the heap in this file:
+**
+** - Requests up to HEAP_MAX_SMALL bytes are rounded up to one of
+**   FICL_HEAP_CLASSES power-of-two size classes and carved from slabs
+**   that hold blocks of a single class. Freed blocks go on a per-class
+**   free list and are reused LIFO.
+** - Larger requests get their own ficlMalloc block, linked into a list.
+** - ficlTermSystem frees all slabs and large blocks in one sweep, so
+**   storage a program forgot to FREE does not outlive the system.
+**
+** Every block is preceded by a HEAP_HDR recording the size class and
+** the requested size (for RESIZE and the statistics).
+*/
+#define HEAP_MIN_SHIFT  4
+#define HEAP_MAX_SMALL  ((size_t)1 << (HEAP_MIN_SHIFT + FICL_HEAP_CLASSES - 1))
+#define HEAP_LARGE      FICL_HEAP_CLASSES
+#define HEAP_SLAB_BYTES 16384
+#define HEAP_SLAB_MIN   8       /* blocks per slab, at least */
+
+typedef struct heap_hdr
+{
+    size_t size;                /* bytes requested */
+    size_t cls;                 /* size class, or HEAP_LARGE */
+} HEAP_HDR;
+
+typedef struct heap_free
+{
+    struct heap_free *link;
+} HEAP_FREE;
+
+typedef struct heap_large
+{
+    struct heap_large *next;
+    struct heap_large *prev;
+} HEAP_LARGE_LINK;
+
+typedef struct heap_slab
+{
+    struct heap_slab *link;
+    size_t pad;                 /* keeps blocks aligned like HEAP_HDR */
+} HEAP_SLAB;
+
+typedef struct ficl_heap
+{
+    HEAP_FREE      *freeList[FICL_HEAP_CLASSES];
+    char           *carve[FICL_HEAP_CLASSES];     /* next unused block in newest slab */
+    char           *carveEnd[FICL_HEAP_CLASSES];
+    HEAP_SLAB      *slabs;
+    HEAP_LARGE_LINK large;                         /* circular list head */
+    FICL_HEAP_STATS stats;
+} FICL_HEAP;
+
+#define HEAP_CLASS_BYTES(cls)  ((size_t)1 << (HEAP_MIN_SHIFT + (cls)))
+#define HEAP_BLOCK_BYTES(cls)  (sizeof (HEAP_HDR) + HEAP_CLASS_BYTES(cls))
+
+
+static size_t heapClass(size_t size)
+{
+    size_t cls = 0;
+
+    if (size > HEAP_MAX_SMALL)
+        return HEAP_LARGE;
+
+    while (HEAP_CLASS_BYTES(cls) < size)
+        cls++;
+
+    return cls;
+}
+
+
+static void heapCount(FICL_HEAP *pHeap, size_t cls, size_t size)
+{
+    FICL_HEAP_STATS *pStats = &pHeap->stats;
+
+    pStats->nLive[cls]++;
+    pStats->nTotal[cls]++;
+    pStats->bytesLive += size;
+    if (pStats->bytesLive > pStats->bytesPeak)
+        pStats->bytesPeak = pStats->bytesLive;
+}
+
+
+/**************************************************************************
+                        h e a p A l l o c
+** Small sizes come off the class free list, or are carved from the
+** class's newest slab, or from a fresh slab. Large sizes get their own
+** block on the large list.
+**************************************************************************/
+static void *heapAlloc(void *pCtx, size_t size)
+{
+    FICL_HEAP *pHeap = (FICL_HEAP *)pCtx;
+    size_t cls = heapClass(size);
+    HEAP_HDR *pHdr;
+
+    if (cls == HEAP_LARGE)
+    {
+        HEAP_LARGE_LINK *pLink = (HEAP_LARGE_LINK *)
+            ficlMalloc(sizeof (HEAP_LARGE_LINK) + sizeof (HEAP_HDR) + size);
+        if (pLink == NULL)
+            return NULL;
+
+        pLink->next = pHeap->large.next;
+        pLink->prev = &pHeap->large;
+        pLink->next->prev = pLink;
+        pHeap->large.next = pLink;
+        pHdr = (HEAP_HDR *)(pLink + 1);
+    }
+    else if (pHeap->freeList[cls] != NULL)
+    {
+        HEAP_FREE *pFree = pHeap->freeList[cls];
+        pHeap->freeList[cls] = pFree->link;
+        pHdr = (HEAP_HDR *)pFree - 1;
+    }
+    else
+    {
+        size_t blockBytes = HEAP_BLOCK_BYTES(cls);
+
+        if (pHeap->carve[cls] == pHeap->carveEnd[cls])
+        {
+            size_t nBlocks = HEAP_SLAB_BYTES / blockBytes;
+            HEAP_SLAB *pSlab;
+
+            if (nBlocks < HEAP_SLAB_MIN)
+                nBlocks = HEAP_SLAB_MIN;
+            pSlab = (HEAP_SLAB *)ficlMalloc(sizeof (HEAP_SLAB) + nBlocks * blockBytes);
+            if (pSlab == NULL)
+                return NULL;
+
+            pSlab->link = pHeap->slabs;
+            pHeap->slabs = pSlab;
+            pHeap->carve[cls]    = (char *)(pSlab + 1);
+            pHeap->carveEnd[cls] = pHeap->carve[cls] + nBlocks * blockBytes;
+        }
+
+        pHdr = (HEAP_HDR *)pHeap->carve[cls];
+        pHeap->carve[cls] += blockBytes;
+    }
+
+    pHdr->size = size;
+    pHdr->cls  = cls;
+    heapCount(pHeap, cls, size);
+    return pHdr + 1;
+}
+
+
+/**************************************************************************
+                        h e a p F r e e
+**
+**************************************************************************/
+static void heapFree(void *pCtx, void *p)
+{
+    FICL_HEAP *pHeap = (FICL_HEAP *)pCtx;
+    HEAP_HDR *pHdr;
+
+    if (p == NULL)
+        return;
+
+    pHdr = (HEAP_HDR *)p - 1;
+#if FICL_ROBUST
+    assert(pHdr->cls <= HEAP_LARGE);
+#endif
+    pHeap->stats.nLive[pHdr->cls]--;
+    pHeap->stats.bytesLive -= pHdr->size;
+
+    if (pHdr->cls == HEAP_LARGE)
+    {
+        HEAP_LARGE_LINK *pLink = (HEAP_LARGE_LINK *)pHdr - 1;
+        pLink->prev->next = pLink->next;
+        pLink->next->prev = pLink->prev;
+        ficlFree(pLink);
+    }
+    else
+    {
+        HEAP_FREE *pFree = (HEAP_FREE *)p;
+        pFree->link = pHeap->freeList[pHdr->cls];
+        pHeap->freeList[pHdr->cls] = pFree;
+    }
+}
+
+
+/**************************************************************************
+                        h e a p R e s i z e
+** Stays in place if the new size still fits the block's class, else
+** moves the contents to a new block.
+**************************************************************************/
+static void *heapResize(void *pCtx, void *p, size_t size)
+{
+    FICL_HEAP *pHeap = (FICL_HEAP *)pCtx;
+    HEAP_HDR *pHdr;
+    void *pNew;
+
+    if (p == NULL)
+        return heapAlloc(pCtx, size);
+
+    pHdr = (HEAP_HDR *)p - 1;
+    if (heapClass(size) == pHdr->cls && pHdr->cls != HEAP_LARGE)
+    {
+        pHeap->stats.bytesLive += size - pHdr->size;
+        if (pHeap->stats.bytesLive > pHeap->stats.bytesPeak)
+            pHeap->stats.bytesPeak = pHeap->stats.bytesLive;
+        pHdr->size = size;
+        return p;
+    }
+
+    pNew = heapAlloc(pCtx, size);
+    if (pNew == NULL)
+        return NULL;
+
+    memcpy(pNew, p, (size < pHdr->size) ? size : pHdr->size);
+    heapFree(pCtx, p);
+    return pNew;
+}
+
+
+/**************************************************************************
+                        h e a p T e r m
+** Releases every slab and large block, then the heap itself.
+**************************************************************************/
+static void heapTerm(void *pCtx)
+{
+    FICL_HEAP *pHeap = (FICL_HEAP *)pCtx;
+    HEAP_LARGE_LINK *pLink = pHeap->large.next;
+
+    while (pHeap->slabs != NULL)
+    {
+        HEAP_SLAB *pSlab = pHeap->slabs;
+        pHeap->slabs = pSlab->link;
+        ficlFree(pSlab);
+    }
+
+    while (pLink != &pHeap->large)
+    {
+        HEAP_LARGE_LINK *pNext = pLink->next;
+        ficlFree(pLink);
+        pLink = pNext;
+    }
+
+    ficlFree(pHeap);
+}
+
+
+/**************************************************************************
+                        f i c l H e a p I n i t
+** Binds the system to the caller's allocator if one is supplied (alloc
+** is non-NULL), otherwise to a new default heap. Called by
+** ficlInitSystemEx.
+**************************************************************************/
+void ficlHeapInit(FICL_SYSTEM *pSys, const FICL_ALLOCATOR *pAllocator)
+{
+    FICL_HEAP *pHeap;
+
+    if (pAllocator && pAllocator->alloc)
+    {
+        assert(pAllocator->free && pAllocator->resize);
+        pSys->allocator = *pAllocator;
+        return;
+    }
+
+    pHeap = (FICL_HEAP *)ficlMalloc(sizeof (FICL_HEAP));
+    assert(pHeap);
+    memset(pHeap, 0, sizeof (FICL_HEAP));
+    pHeap->large.next = pHeap->large.prev = &pHeap->large;
+
+    pSys->allocator.alloc  = heapAlloc;
+    pSys->allocator.resize = heapResize;
+    pSys->allocator.free   = heapFree;
+    pSys->allocator.term   = heapTerm;
+    pSys->allocator.pCtx   = pHeap;
+}
+
+
+/**************************************************************************
+                        f i c l H e a p T e r m
+** Called by ficlTermSystem - gives the allocator a chance to release
+** anything still outstanding.
+**************************************************************************/
+void ficlHeapTerm(FICL_SYSTEM *pSys)
+{
+    if (pSys->allocator.term)
+        pSys->allocator.term(pSys->allocator.pCtx);
+    memset(&pSys->allocator, 0, sizeof (FICL_ALLOCATOR));
+}
+
+
+/**************************************************************************
+                        f i c l H e a p A l l o c   e t c
+** Entry points for C code that wants the same storage as ALLOCATE
+**************************************************************************/
+void *ficlHeapAlloc(FICL_SYSTEM *pSys, size_t size)
+{
+    return pSys->allocator.alloc(pSys->allocator.pCtx, size);
+}
+
+void *ficlHeapResize(FICL_SYSTEM *pSys, void *p, size_t size)
+{
+    return pSys->allocator.resize(pSys->allocator.pCtx, p, size);
+}
+
+void ficlHeapFree(FICL_SYSTEM *pSys, void *p)
+{
+    pSys->allocator.free(pSys->allocator.pCtx, p);
+}
+
+
+/**************************************************************************
+                        f i c l H e a p S t a t s
+** Returns the default heap's statistics, or NULL if the system uses a
+** host-supplied allocator.
+**************************************************************************/
+const FICL_HEAP_STATS *ficlHeapStats(FICL_SYSTEM *pSys)
+{
+    if (pSys->allocator.alloc != heapAlloc)
+        return NULL;
+    return &((FICL_HEAP *)pSys->allocator.pCtx)->stats;
+}
+
+
+/**************************************************************************
+                        r e g i o n s
+** alloc-mark starts (or nests) a region on the VM. Until the matching
+** alloc-release, ALLOCATE bump-allocates from chunks the region takes
+** from the system heap, FREE of a region block is a no-op, and RESIZE
+** grows the newest block in place when it can. alloc-release drops the
+** region's top back to the mark - one store, however many blocks were
+** handed out - and returns any chunks opened since the mark to the heap.
+** The oldest chunk is kept for the next request.
+**
+** Region offsets run continuously across chunks: each chunk starts at
+** the offset where the previous chunk ended, so a mark is just the
+** offset of the region top when alloc-mark ran.
+**************************************************************************/
+struct ficl_region_chunk
+{
+    FICL_REGION_CHUNK *link;    /* older chunk */
+    size_t start;               /* region offset of data[0] */
+    size_t size;                /* bytes in data[] */
+    size_t used;
+    HEAP_HDR data[];            /* HEAP_HDR only for alignment */
+};
+
+#define REGION_ALIGN(n)  (((n) + sizeof (HEAP_HDR) - 1) & ~(sizeof (HEAP_HDR) - 1))
+
+static size_t regionTop(FICL_REGION *pRegion)
+{
+    FICL_REGION_CHUNK *pChunk = pRegion->pChunk;
+    return pChunk ? pChunk->start + pChunk->used : 0;
+}
+
+
+static FICL_REGION_CHUNK *regionOwner(FICL_REGION *pRegion, const void *p)
+{
+    FICL_REGION_CHUNK *pChunk;
+
+    for (pChunk = pRegion->pChunk; pChunk != NULL; pChunk = pChunk->link)
+    {
+        const char *cp = (const char *)pChunk->data;
+        if (((const char *)p >= cp) && ((const char *)p < cp + pChunk->used))
+            return pChunk;
+    }
+
+    return NULL;
+}
+
+
+/*
+** Each region block is a HEAP_HDR (size only) followed by the payload
+*/
+static void *regionAlloc(FICL_VM *pVM, size_t size)
+{
+    FICL_REGION *pRegion = &pVM->region;
+    FICL_REGION_CHUNK *pChunk = pRegion->pChunk;
+    size_t need = sizeof (HEAP_HDR) + REGION_ALIGN(size);
+    HEAP_HDR *pHdr;
+
+    if ((pChunk == NULL) || (pChunk->size - pChunk->used < need))
+    {
+        size_t chunkSize = (need > FICL_REGION_CHUNK_BYTES) ? need : FICL_REGION_CHUNK_BYTES;
+        FICL_REGION_CHUNK *pNew = (FICL_REGION_CHUNK *)
+            ficlHeapAlloc(pVM->pSys, sizeof (FICL_REGION_CHUNK) + chunkSize);
+        if (pNew == NULL)
+            return NULL;
+
+        pNew->link  = pChunk;
+        pNew->start = pChunk ? pChunk->start + pChunk->size : 0;
+        pNew->size  = chunkSize;
+        pNew->used  = 0;
+        pRegion->pChunk = pChunk = pNew;
+    }
+
+    pHdr = (HEAP_HDR *)((char *)pChunk->data + pChunk->used);
+    pHdr->size = size;
+    pHdr->cls  = HEAP_LARGE + 1;    /* not a heap block */
+    pChunk->used += need;
+    return pHdr + 1;
+}
+
+
+FICL_UNS ficlAllocMark(FICL_VM *pVM)
+{
+    FICL_REGION *pRegion = &pVM->region;
+
+    if (pRegion->nMarks >= FICL_MAX_ALLOC_MARKS)
+        return 0;
+
+    pRegion->marks[pRegion->nMarks++] = regionTop(pRegion);
+    return pRegion->nMarks;
+}
+
+
+void ficlAllocRelease(FICL_VM *pVM, FICL_UNS mark)
+{
+    FICL_REGION *pRegion = &pVM->region;
+    size_t top;
+
+    assert((mark > 0) && (mark <= pRegion->nMarks));
+    top = pRegion->marks[mark - 1];
+    pRegion->nMarks = mark - 1;
+
+    if (pRegion->pChunk == NULL)    /* nothing allocated since the mark */
+        return;
+
+    while ((pRegion->pChunk->start > top) && (pRegion->pChunk->link != NULL))
+    {
+        FICL_REGION_CHUNK *pChunk = pRegion->pChunk;
+        pRegion->pChunk = pChunk->link;
+        ficlHeapFree(pVM->pSys, pChunk);
+    }
+
+    pRegion->pChunk->used = top - pRegion->pChunk->start;
+}
+
+
+void *ficlAllocate(FICL_VM *pVM, size_t size)
+{
+    if (pVM->region.nMarks > 0)
+        return regionAlloc(pVM, size);
+    return ficlHeapAlloc(pVM->pSys, size);
+}
+
+
+void *ficlAllocResize(FICL_VM *pVM, void *p, size_t size)
+{
+    FICL_REGION *pRegion = &pVM->region;
+    FICL_REGION_CHUNK *pChunk = p ? regionOwner(pRegion, p) : NULL;
+    HEAP_HDR *pHdr;
+    void *pNew;
+    int fNewest;
+
+    if (pChunk == NULL)
+    {
+        if (p == NULL)
+            return ficlAllocate(pVM, size);
+        return ficlHeapResize(pVM->pSys, p, size);
+    }
+
+    /*
+    ** The newest block in the chunk can grow or shrink in place, as long
+    ** as no mark was taken after it: releasing that mark would cut the
+    ** block back to its old size.
+    */
+    pHdr = (HEAP_HDR *)p - 1;
+    fNewest = (pRegion->nMarks > 0)
+        && (pChunk->start + (size_t)((char *)pHdr - (char *)pChunk->data)
+            >= pRegion->marks[pRegion->nMarks - 1]);
+    if (fNewest
+        && ((char *)p + REGION_ALIGN(pHdr->size) == (char *)pChunk->data + pChunk->used))
+    {
+        size_t used = (size_t)((char *)p - (char *)pChunk->data);
+        if (pChunk->size - used >= REGION_ALIGN(size))
+        {
+            pChunk->used = used + REGION_ALIGN(size);
+            pHdr->size = size;
+            return p;
+        }
+    }
+
+    /*
+    ** Otherwise move it. A block of the newest mark moves within the
+    ** region; a block of an outer mark goes to the heap, since the
+    ** region top now belongs to a mark nested inside its own. The old
+    ** copy goes when its mark is released.
+    */
+    pNew = fNewest ? regionAlloc(pVM, size) : ficlHeapAlloc(pVM->pSys, size);
+    if (pNew)
+        memcpy(pNew, p, (size < pHdr->size) ? size : pHdr->size);
+    return pNew;
+}
+
+
+void ficlAllocFree(FICL_VM *pVM, void *p)
+{
+    if ((p != NULL) && (regionOwner(&pVM->region, p) == NULL))
+        ficlHeapFree(pVM->pSys, p);
+}
+
+
+/*
+** Called by vmDelete
+*/
+void ficlRegionDelete(FICL_VM *pVM)
+{
+    FICL_REGION *pRegion = &pVM->region;
+
+    while (pRegion->pChunk != NULL)
+    {
+        FICL_REGION_CHUNK *pChunk = pRegion->pChunk;
+        pRegion->pChunk = pChunk->link;
+        ficlHeapFree(pVM->pSys, pChunk);
+    }
+
+    pRegion->nMarks = 0;
+}
+
+
+/**************************************************************************
+                        a l l o c - m a r k
+** alloc-mark    ( -- mark )
+** Start a region: until the matching alloc-release, ALLOCATE takes
+** storage from the VM's region and FREE of it is a no-op. Marks nest.
+** alloc-release ( mark -- )
+** Free everything allocated since mark, and release any marks nested
+** inside it.
+**************************************************************************/
+static void allocMark(FICL_VM *pVM)
+{
+    FICL_UNS mark;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 0, 1);
+#endif
+
+    mark = ficlAllocMark(pVM);
+    if (mark == 0)
+        vmThrowErr(pVM, "Error: alloc-mark nested too deep");
+    PUSHUNS(mark);
+}
+
+
+static void allocRelease(FICL_VM *pVM)
+{
+    FICL_UNS mark;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 1, 0);
+#endif
+
+    mark = POPUNS();
+    if ((mark == 0) || (mark > pVM->region.nMarks))
+        vmThrowErr(pVM, "Error: alloc-release: not an active mark");
+    ficlAllocRelease(pVM, mark);
+}
+
+
+/**************************************************************************
+                        h e a p - l i v e   e t c
+** heap-live   ( -- u )   bytes currently allocated by ALLOCATE/RESIZE
+** heap-peak   ( -- u )   high water mark of heap-live
+** heap-class  ( n -- u-size u-live u-total )
+**      block size, live and lifetime allocation counts for size class n
+**      (0 .. heap-classes - 1). Class heap-classes is the large-block
+**      list; its size reads as 0.
+** heap-classes ( -- n )
+** .heap       ( -- )     print the above
+** All read as zero if the host supplied its own allocator.
+**************************************************************************/
+static void heapLive(FICL_VM *pVM)
+{
+    const FICL_HEAP_STATS *pStats = ficlHeapStats(pVM->pSys);
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 0, 1);
+#endif
+    PUSHUNS(pStats ? pStats->bytesLive : 0);
+}
+
+
+static void heapPeak(FICL_VM *pVM)
+{
+    const FICL_HEAP_STATS *pStats = ficlHeapStats(pVM->pSys);
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 0, 1);
+#endif
+    PUSHUNS(pStats ? pStats->bytesPeak : 0);
+}
+
+
+static void heapClasses(FICL_VM *pVM)
+{
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 0, 1);
+#endif
+    PUSHUNS(FICL_HEAP_CLASSES);
+}
+
+
+static void heapClassInfo(FICL_VM *pVM)
+{
+    const FICL_HEAP_STATS *pStats = ficlHeapStats(pVM->pSys);
+    FICL_UNS cls;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 1, 3);
+#endif
+
+    cls = POPUNS();
+    if (cls > FICL_HEAP_CLASSES)
+        vmThrowErr(pVM, "Error: heap-class: no such class");
+
+    PUSHUNS((cls < FICL_HEAP_CLASSES) ? HEAP_CLASS_BYTES(cls) : 0);
+    PUSHUNS(pStats ? pStats->nLive[cls]  : 0);
+    PUSHUNS(pStats ? pStats->nTotal[cls] : 0);
+}
+
+
+static void heapDisplay(FICL_VM *pVM)
+{
+    const FICL_HEAP_STATS *pStats = ficlHeapStats(pVM->pSys);
+    int cls;
+
+    if (pStats == NULL)
+    {
+        vmTextOut(pVM, "heap: host allocator - no statistics", true);
+        return;
+    }
+
+    vmTextOut(pVM, " size       live      total", true);
+    for (cls = 0; cls <= FICL_HEAP_CLASSES; cls++)
+    {
+        if (cls < FICL_HEAP_CLASSES)
+            snprintf(pVM->pad, sizeof (pVM->pad), "%5u %10lu %10lu", (unsigned)HEAP_CLASS_BYTES(cls),
+                     (unsigned long)pStats->nLive[cls], (unsigned long)pStats->nTotal[cls]);
+        else
+            snprintf(pVM->pad, sizeof (pVM->pad), "large %10lu %10lu",
+                     (unsigned long)pStats->nLive[cls], (unsigned long)pStats->nTotal[cls]);
+        vmTextOut(pVM, pVM->pad, true);
+    }
+
+    snprintf(pVM->pad, sizeof (pVM->pad), "bytes live: %lu  peak: %lu",
+             (unsigned long)pStats->bytesLive, (unsigned long)pStats->bytesPeak);
+    vmTextOut(pVM, pVM->pad, true);
+}
+
+
+/**************************************************************************
+                        f i c l C o m p i l e H e a p
+** Builds the heap statistics and region words into the dictionary
+**************************************************************************/
+void ficlCompileHeap(FICL_SYSTEM *pSys)
+{
+    FICL_DICT *dp = pSys->dp;
+    assert (dp);
+
+    dictAppendWord(dp, "heap-live",    heapLive,      FW_DEFAULT);
+    dictAppendWord(dp, "heap-peak",    heapPeak,      FW_DEFAULT);
+    dictAppendWord(dp, "heap-classes", heapClasses,   FW_DEFAULT);
+    dictAppendWord(dp, "heap-class",   heapClassInfo, FW_DEFAULT);
+    dictAppendWord(dp, ".heap",        heapDisplay,   FW_DEFAULT);
+    dictAppendWord(dp, "alloc-mark",   allocMark,     FW_DEFAULT);
+    dictAppendWord(dp, "alloc-release", allocRelease, FW_DEFAULT);
+    return;
+}
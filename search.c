@@ -355,6 +355,7 @@ static void setParentWid(FICL_VM *pVM)
     parent = (FICL_HASH *)stackPopPtr(pVM->pStack);
 
     child->link = parent;
+    ficlHashEpoch++;
     return;
 }
 
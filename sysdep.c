@@ -77,6 +77,17 @@ void  ficlTextOut(FICL_VM *pVM, const char *msg, bool fNewline)
     return;
 }
 
+void  ficlTextOutN(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
+{
+    FICL_IGNORE(pVM);
+
+    fwrite(text, 1, len, stdout);
+    if (fNewline)
+        putchar('\n');
+
+    return;
+}
+
 void *ficlMalloc (size_t size)
 {
     return malloc(size);
@@ -167,6 +178,17 @@ void  ficlTextOut(FICL_VM *pVM, const char *msg, bool fNewline)
     return;
 }
 
+void  ficlTextOutN(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
+{
+    FICL_IGNORE(pVM);
+
+    fwrite(text, 1, len, stdout);
+    if (fNewline)
+        putchar('\n');
+
+    return;
+}
+
 void *ficlMalloc (size_t size)
 {
     return malloc(size);
@@ -233,6 +255,17 @@ void  ficlFree   (void *p)
 
        return;
     }
+
+    void ficlTextOutN(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
+    {
+        FICL_IGNORE(pVM);
+
+        fwrite(text, 1, len, stdout);
+        if (fNewline)
+            putchar('\n');
+
+        return;
+    }
 #endif
 
 void *ficlMalloc (size_t size)
@@ -300,6 +333,11 @@ void  ficlTextOut(FICL_VM *pVM, const char *msg, bool fNewline)
     return;
 }
 
+void  ficlTextOutN(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
+{
+    return;
+}
+
 void *ficlMalloc (size_t size)
 {
 }
@@ -375,6 +413,17 @@ void  ficlTextOut(FICL_VM *pVM, const char *msg, bool fNewline)
     return;
 }
 
+void  ficlTextOutN(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
+{
+    FICL_IGNORE(pVM);
+
+    fwrite(text, 1, len, stdout);
+    if (fNewline)
+        putchar('\n');
+
+    return;
+}
+
 void *ficlMalloc (size_t size)
 {
     return malloc(size);
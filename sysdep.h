@@ -100,6 +100,8 @@ static_assert(CELL_ALIGN > 0, "Unsupported CELL_BITS value");
 #include <TargetConditionals.h>
     #if TARGET_OS_OSX
         #define FICL_HAVE_FTRUNCATE 1
+        #define FICL_HAVE_MMAP 1
+        #define FICL_HAVE_WRITEV 1
 
         #define MACOS
     #elif TARGET_OS_IOS
@@ -113,6 +115,9 @@ static_assert(CELL_ALIGN > 0, "Unsupported CELL_BITS value");
 */
 #if defined(linux)
     #define FICL_HAVE_FTRUNCATE 1
+    #define FICL_HAVE_MMAP 1
+    #define FICL_HAVE_WRITEV 1
+    #define FICL_HAVE_SENDFILE 1
 #endif
 
 /*
@@ -184,6 +189,7 @@ typedef jmp_buf FICL_JMP_BUF;
 #if (FICL_MINIMAL)
 #define FICL_WANT_SOFTWORDS  0
 #define FICL_WANT_FILE       0
+#define FICL_WANT_ASYNC_IO   0
 #define FICL_WANT_FLOAT      0
 #define FICL_WANT_USER       0
 #define FICL_WANT_RANDOM     0
@@ -194,6 +200,7 @@ typedef jmp_buf FICL_JMP_BUF;
 #define FICL_ROBUST          0
 #define FICL_EXTENDED_PREFIX 0
 #define FICL_WANT_INTERRUPT  0
+#define FICL_WANT_GUARD_PAGES 0
 #endif
 
 
@@ -216,6 +223,49 @@ typedef jmp_buf FICL_JMP_BUF;
 #define FICL_WANT_FILE 1
 #endif
 
+/*
+** FICL_WANT_ASYNC_IO (POSIX threads - link with -lpthread)
+** Adds read-file-async, write-file-async, io-poll and io-wait to the
+** FILE wordset. Requests run on a pool of FICL_AIO_THREADS worker
+** threads, started on first use and shared by all of a system's VMs,
+** so a VM can overlap file I/O with other work.
+*/
+#if !defined (FICL_WANT_ASYNC_IO)
+#if defined(linux) || defined(MACOS)
+#define FICL_WANT_ASYNC_IO FICL_WANT_FILE
+#else
+#define FICL_WANT_ASYNC_IO 0
+#endif
+#endif
+#if !FICL_WANT_FILE
+#undef  FICL_WANT_ASYNC_IO
+#define FICL_WANT_ASYNC_IO 0
+#endif
+
+#if !defined (FICL_AIO_THREADS)
+#define FICL_AIO_THREADS 2
+#endif
+
+/*
+** FICL_INCLUDE_CHUNK
+** ficlExecRefill (and so INCLUDE-FILE, for files it can't map) pulls
+** source text this many bytes at a time and interprets it a line at a
+** time, so memory use is bounded by the chunk size (or the longest
+** line, if that is bigger) rather than by the size of the source.
+*/
+#if !defined (FICL_INCLUDE_CHUNK)
+#define FICL_INCLUDE_CHUNK 65536
+#endif
+
+/*
+** FICL_READLINE_BUF
+** Size of the buffer READ-LINE and READ-LINE-REF read through, per open
+** file. It grows if READ-LINE-REF meets a longer line.
+*/
+#if !defined (FICL_READLINE_BUF)
+#define FICL_READLINE_BUF 8192
+#endif
+
 /*
 ** FICL_WANT_FLOAT
 ** Includes a floating point stack for the VM, and words to do float and float extension operations.
@@ -263,6 +313,16 @@ typedef jmp_buf FICL_JMP_BUF;
     #define FICL_WANT_USER 1
 #endif
 
+/*
+** FICL_WANT_VCALL
+** Per-class method vtables for the OOP classes in oo.fr. Classes carry
+** a vtable pointer ahead of their payload size, filled in by END-CLASS,
+** and ==> compiles virtual calls that index it by slot.
+*/
+#if !defined (FICL_WANT_VCALL)
+    #define FICL_WANT_VCALL 1
+#endif
+
 /*
 ** User variables: per-instance variables bound to the VM.
 ** Kinda like thread-local storage. Could be implemented in a
@@ -295,6 +355,17 @@ typedef jmp_buf FICL_JMP_BUF;
 #define FICL_MAX_LOCALS 32
 #endif
 
+/*
+** Max nesting depth of alloc-mark (per VM), and the size of the chunks
+** the mark/release region grabs from the heap
+*/
+#if !defined FICL_MAX_ALLOC_MARKS
+#define FICL_MAX_ALLOC_MARKS 16
+#endif
+#if !defined FICL_REGION_CHUNK_BYTES
+#define FICL_REGION_CHUNK_BYTES 8192
+#endif
+
 /*
 ** FICL_WANT_INTERRUPT
 ** Enables vmInterrupt() for breaking a VM out of an endless loop from a
@@ -359,6 +430,48 @@ typedef jmp_buf FICL_JMP_BUF;
 #define FICL_DEFAULT_STACK 256
 #endif
 
+/*
+** FICL_STACK_GUARD specifies the number of CELLs of guard gap that
+** vmCreate places after each stack in a VM's single allocation. The
+** gaps are filled with a known pattern so that overruns land in
+** dead space (and can be detected by vmCheckGuards) rather than
+** trashing the next stack. Set to 0 to pack the stacks tightly.
+*/
+#if !defined FICL_STACK_GUARD
+#define FICL_STACK_GUARD 4
+#endif
+
+/*
+** FICL_OUTBUF_SIZE specifies the size in bytes of each VM's output
+** buffer. vmTextOut batches output there and hands it to the VM's
+** OUTFUNC at each newline, when the buffer fills, on flush-output,
+** and when ficlExec returns. 0 makes output unbuffered. Change it
+** per VM with vmSetOutputSize.
+*/
+#if !defined FICL_OUTBUF_SIZE
+#define FICL_OUTBUF_SIZE 512
+#endif
+
+/*
+** FICL_WANT_GUARD_PAGES (POSIX only)
+** Maps each new VM with mmap and brackets each of its stacks with
+** PROT_NONE guard pages. A SIGSEGV handler turns a fault inside a VM's
+** guard region into vmThrowOverflow/vmThrowUnderflow via the VM's jmp_buf,
+** so stack overruns are caught with no per-instruction cost. Intended for
+** builds with FICL_ROBUST 0 or 1 - an underflow shallower than the stack
+** header (3 cells) is not trapped, but FICL_ROBUST 1 catches it in the
+** outer interpreter. Stack sizes round up to whole pages. The handler
+** chains to any previously installed SIGSEGV/SIGBUS handler for faults
+** it does not own.
+*/
+#if !defined FICL_WANT_GUARD_PAGES
+#define FICL_WANT_GUARD_PAGES 0
+#endif
+#if FICL_WANT_GUARD_PAGES && (defined(_WIN32) || defined(__EMSCRIPTEN__) || !(defined(__unix__) || defined(__APPLE__)))
+#undef  FICL_WANT_GUARD_PAGES
+#define FICL_WANT_GUARD_PAGES 0
+#endif
+
 /*
 ** FICL_DEFAULT_DICT specifies the number of CELLs to allocate
 ** for the system dictionary by default. The value
@@ -508,6 +621,8 @@ typedef struct
 **
 ** ficlTextOut sends a NULL terminated string to the
 **   default output device - used for system error messages
+** ficlTextOutN sends len bytes of text (not necessarily NULL
+**   terminated) to the same device
 ** ficlMalloc and ficlFree have the same semantics as malloc and free
 **   in standard C
 ** ficlLongMul multiplies two UNS32s and returns a 64 bit unsigned
@@ -517,6 +632,7 @@ typedef struct
 */
 struct vm;
 void  ficlTextOut(struct vm *pVM, const char *msg, bool fNewline);
+void  ficlTextOutN(struct vm *pVM, const char *text, size_t len, bool fNewline);
 void *ficlMalloc (size_t size);
 void  ficlFree   (void *p);
 void *ficlRealloc(void *p, size_t size);
@@ -561,5 +677,66 @@ UNSQR ficlLongDiv(DPUNS    q, FICL_UNS y);
 #define FICL_HAVE_FTRUNCATE 1
 #endif
 
+/*
+** FICL_HAVE_MMAP indicates whether the current OS supports mmap() and
+** posix_madvise(). If so, include-file maps regular files and
+** interprets them in place instead of reading them.
+*/
+#if !defined (FICL_HAVE_MMAP)
+#define FICL_HAVE_MMAP 0
+#endif
+
+/*
+** FICL_HAVE_WRITEV indicates whether the current OS supports writev().
+** If so, write-filev hands all its pieces to the OS in one call;
+** otherwise it writes them one at a time.
+*/
+#if !defined (FICL_HAVE_WRITEV)
+#define FICL_HAVE_WRITEV 0
+#endif
+
+/*
+** FICL_HAVE_SENDFILE indicates whether the current OS has a Linux-style
+** sendfile() that copies between regular files inside the kernel. If
+** not, copy-file-range copies through a C buffer.
+*/
+#if !defined (FICL_HAVE_SENDFILE)
+#define FICL_HAVE_SENDFILE 0
+#endif
+
+/*
+** FICL_WANT_RAW_IO (POSIX only)
+** READ-FILE and WRITE-FILE on files opened with BIN move blocks of
+** FICL_RAW_IO_MIN bytes or more with read() and write() on the file's
+** descriptor, skipping the copy through the stdio buffer. Smaller
+** transfers still go through stdio, where buffering pays.
+*/
+#if !defined (FICL_WANT_RAW_IO)
+#if defined(linux) || defined(MACOS)
+#define FICL_WANT_RAW_IO 1
+#else
+#define FICL_WANT_RAW_IO 0
+#endif
+#endif
+
+#if !defined (FICL_RAW_IO_MIN)
+#define FICL_RAW_IO_MIN 4096
+#endif
+
+/*
+** FICL_HAVE_SSE2 indicates that the compiler targets a CPU with SSE2
+** (every x86-64, and 32 bit x86 built with -msse2 or /arch:SSE2).
+** If so, the case-folding COMPARE and SKIP kernels in vm.c work 16
+** bytes at a time, and the fv- float vector words in float.c 16 bytes
+** of floats at a time; otherwise they loop element by element.
+*/
+#if !defined (FICL_HAVE_SSE2)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define FICL_HAVE_SSE2 1
+#else
+#define FICL_HAVE_SSE2 0
+#endif
+#endif
+
 
 #endif /*__SYSDEP_H__*/
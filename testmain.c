@@ -786,7 +786,9 @@ static void ficlSystem(FICL_VM *pVM)
     vmGetString(pVM, pFS, '\n');
     if (pFS->count > 0)
     {
-        int err = system(pFS->text);
+        int err;
+        vmFlushOutput(pVM);     /* keep our output ahead of the command's */
+        err = system(pFS->text);
         if (err)
         {
             snprintf(pVM->scratch, sizeof(pVM->scratch), "System call returned %d", err);
@@ -1107,6 +1109,512 @@ void buildTestInterface(FICL_SYSTEM *pSys)
         dictDelete(dp);
     }
 
+    /* vmArenaLayoutTest - VM and stacks share one block, guards detect overruns */
+    static void vmArenaLayoutTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVMEx(pSys, 64, 32);
+        const char *lo    = (const char *)pVM;
+        const char *hi    = lo + pVM->arenaBytes;
+
+        TEST_ASSERT_TRUE((const char *)pVM->pStack > lo && (const char *)pVM->pStack < hi);
+        TEST_ASSERT_TRUE((const char *)pVM->rStack > lo && (const char *)pVM->rStack < hi);
+        TEST_ASSERT_TRUE(pVM->pStack->nCells >= 64);   /* guard pages round up */
+        TEST_ASSERT_TRUE(pVM->rStack->nCells >= 32);
+#if FICL_WANT_FLOAT
+        TEST_ASSERT_TRUE((const char *)pVM->fStack > lo && (const char *)pVM->fStack < hi);
+        TEST_ASSERT_TRUE(pVM->fStack->nCells >= 64);
+#endif
+
+        TEST_ASSERT_EQUAL_INT(VM_OUTOFTEXT, ficlEvaluate(pVM, ": sq dup * ; 7 sq drop"));
+        TEST_ASSERT_TRUE(vmCheckGuards(pVM));
+
+#if (FICL_STACK_GUARD > 0) && !FICL_WANT_GUARD_PAGES
+        pVM->pStack->base[pVM->pStack->nCells].i = 0;
+        TEST_ASSERT_FALSE(vmCheckGuards(pVM));
+#endif
+
+        ficlTermSystem(pSys);
+    }
+
+    /* heapStatsTest - ALLOCATE/RESIZE/FREE go through the default size-class heap */
+    static void heapStatsTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVM(pSys);
+        const FICL_HEAP_STATS *pStats = ficlHeapStats(pSys);
+        size_t live0;
+
+        TEST_ASSERT_NOT_NULL(pStats);
+        live0 = pStats->bytesLive;
+
+        ficlEvaluate(pVM, "variable p1  variable p2  variable p3");
+        ficlEvaluate(pVM, "10 allocate drop p1 !  100 allocate drop p2 !  5000 allocate drop p3 !");
+        TEST_ASSERT_EQUAL_INT(live0 + 5110, pStats->bytesLive);
+        TEST_ASSERT_TRUE(pStats->nLive[0] >= 1);                  /* 16 byte class */
+        TEST_ASSERT_TRUE(pStats->nLive[FICL_HEAP_CLASSES] >= 1);  /* large block */
+
+        ficlEvaluate(pVM, "p1 @ 12 resize drop p1 !");             /* same class: in place */
+        TEST_ASSERT_EQUAL_INT(live0 + 5112, pStats->bytesLive);
+
+        ficlEvaluate(pVM, "p1 @ free drop  p2 @ free drop  p3 @ free drop");
+        TEST_ASSERT_EQUAL_INT(live0, pStats->bytesLive);
+        TEST_ASSERT_TRUE(pStats->bytesPeak >= live0 + 5112);
+
+        /* left allocated on purpose: ficlTermSystem sweeps it up */
+        ficlEvaluate(pVM, "64 allocate 2drop");
+        ficlTermSystem(pSys);
+    }
+
+    static int nHostAllocs;
+    static void *hostAlloc(void *pCtx, size_t size)           { (void)pCtx; nHostAllocs++; return malloc(size); }
+    static void *hostResize(void *pCtx, void *p, size_t size) { (void)pCtx; return realloc(p, size); }
+    static void  hostFree(void *pCtx, void *p)                { (void)pCtx; nHostAllocs--; free(p); }
+
+    /* heapHostAllocatorTest - a FICL_SYSTEM_INFO allocator replaces the default heap */
+    static void heapHostAllocatorTest(void)
+    {
+        FICL_SYSTEM_INFO fsi;
+        FICL_SYSTEM *pSys;
+        FICL_VM *pVM;
+
+        memset(&fsi, 0, sizeof (fsi));
+        fsi.size = sizeof (fsi);
+        fsi.nDictCells = 20000;
+        fsi.allocator.alloc  = hostAlloc;
+        fsi.allocator.resize = hostResize;
+        fsi.allocator.free   = hostFree;
+        pSys = ficlInitSystemEx(&fsi);
+        pVM  = ficlNewVM(pSys);
+
+        nHostAllocs = 0;
+        ficlEvaluate(pVM, "100 allocate drop 200 resize drop");
+        TEST_ASSERT_EQUAL_INT(1, nHostAllocs);
+        TEST_ASSERT_NULL(ficlHeapStats(pSys));
+        ficlEvaluate(pVM, "free drop");
+        TEST_ASSERT_EQUAL_INT(0, nHostAllocs);
+
+        ficlTermSystem(pSys);
+    }
+
+    /* allocRegionTest - ALLOCATE inside alloc-mark comes from the region; release frees it */
+    static void allocRegionTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVM(pSys);
+        FICL_UNS outer, inner;
+        char *p1, *p2, *p3;
+
+        /* a mark released before anything was allocated: no chunk yet */
+        ficlAllocRelease(pVM, ficlAllocMark(pVM));
+        TEST_ASSERT_EQUAL_INT(0, pVM->region.nMarks);
+        TEST_ASSERT_NULL(pVM->region.pChunk);
+
+        outer = ficlAllocMark(pVM);
+        p1 = (char *)ficlAllocate(pVM, 100);
+        TEST_ASSERT_NOT_NULL(p1);
+
+        inner = ficlAllocMark(pVM);
+        p2 = (char *)ficlAllocate(pVM, 20000);      /* bigger than a chunk */
+        p3 = (char *)ficlAllocate(pVM, 10);
+        strcpy(p3, "abc");
+        TEST_ASSERT_EQUAL_PTR(p3, ficlAllocResize(pVM, p3, 40)); /* newest block grows in place */
+        TEST_ASSERT_EQUAL_STRING("abc", p3);
+        ficlAllocFree(pVM, p2);                     /* no-op inside a region */
+        ficlAllocRelease(pVM, inner);
+
+        /* space after the inner mark is reused */
+        TEST_ASSERT_EQUAL_PTR(p1 + 112 + 16, ficlAllocate(pVM, 8));
+        ficlAllocRelease(pVM, outer);
+        TEST_ASSERT_EQUAL_INT(0, pVM->region.nMarks);
+
+        /* an outer mark's block resized under an inner mark outlives the inner release */
+        outer = ficlAllocMark(pVM);
+        p1 = (char *)ficlAllocate(pVM, 16);
+        p2 = (char *)ficlAllocate(pVM, 16);
+        memset(p1, 'A', 16);
+        inner = ficlAllocMark(pVM);
+        p1 = (char *)ficlAllocResize(pVM, p1, 200);  /* not newest in chunk: moves */
+        ficlAllocRelease(pVM, inner);
+        memset(ficlAllocate(pVM, 64), 'Z', 64);
+        TEST_ASSERT_EQUAL_CHAR('A', p1[0]);
+        ficlAllocFree(pVM, p1);
+
+        inner = ficlAllocMark(pVM);
+        p3 = (char *)ficlAllocResize(pVM, p2, 200);  /* newest in chunk, but older than inner */
+        TEST_ASSERT_TRUE(p3 != p2);
+        memset(p3, 'A', 200);
+        ficlAllocRelease(pVM, inner);
+        memset(ficlAllocate(pVM, 64), 'Z', 64);
+        TEST_ASSERT_EQUAL_CHAR('A', p3[40]);
+        ficlAllocFree(pVM, p3);
+        ficlAllocRelease(pVM, outer);
+
+        /* Forth side: releasing the outer mark also releases the inner one */
+        TEST_ASSERT_EQUAL_INT(VM_OUTOFTEXT, ficlEvaluate(pVM,
+            "alloc-mark  64 allocate 2drop  alloc-mark drop  64 allocate 2drop  alloc-release"));
+        TEST_ASSERT_EQUAL_INT(0, pVM->region.nMarks);
+        TEST_ASSERT_EQUAL_INT(VM_ERREXIT, ficlEvaluate(pVM, "5 alloc-release"));
+
+        ficlTermSystem(pSys);
+    }
+
+    static int  nOutCalls;
+    static char outText[1024];
+    static void countTextOut(FICL_VM *pVM, const char *text, bool fNewline)
+    {
+        (void)pVM;
+        nOutCalls++;
+        strcat(outText, text);
+        if (fNewline)
+            strcat(outText, "\n");
+    }
+
+    /* vmOutputBufferTest - output batches until newline, flush-output, or return from ficlExec */
+    static void vmOutputBufferTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVM(pSys);
+
+        vmSetTextOut(pVM, countTextOut);
+        ficlEvaluate(pVM, ": xs  0 ?do [char] x emit loop ;");
+
+        nOutCalls = 0; outText[0] = '\0';
+        ficlEvaluate(pVM, "20 xs");
+        TEST_ASSERT_EQUAL_INT(1, nOutCalls);
+        TEST_ASSERT_EQUAL_STRING("xxxxxxxxxxxxxxxxxxxx", outText);
+
+        nOutCalls = 0; outText[0] = '\0';
+        ficlEvaluate(pVM, "3 xs cr 2 xs flush-output 1 xs");
+        TEST_ASSERT_EQUAL_INT(3, nOutCalls);
+        TEST_ASSERT_EQUAL_STRING("xxx\nxxx", outText);
+
+        /* unbuffered: one call per emit */
+        TEST_ASSERT_TRUE(vmSetOutputSize(pVM, 0));
+        nOutCalls = 0; outText[0] = '\0';
+        ficlEvaluate(pVM, "5 xs");
+        TEST_ASSERT_EQUAL_INT(5, nOutCalls);
+
+        /* a small buffer flushes when full */
+        TEST_ASSERT_TRUE(vmSetOutputSize(pVM, 8));
+        nOutCalls = 0; outText[0] = '\0';
+        ficlEvaluate(pVM, "20 xs");
+        TEST_ASSERT_EQUAL_INT(3, nOutCalls);
+        TEST_ASSERT_EQUAL_INT(20, (int)strlen(outText));
+
+        ficlTermSystem(pSys);
+    }
+
+    static void lenTextOut(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
+    {
+        (void)pVM;
+        nOutCalls++;
+        strncat(outText, text, len);
+        if (fNewline)
+            strcat(outText, "\n");
+    }
+
+    /* vmTextOutNTest - length-delimited output: no copy to HERE, legacy textOut still works */
+    static void vmTextOutNTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVM(pSys);
+        char        big[600];
+        char       *here;
+
+        vmSetTextOutN(pVM, lenTextOut);
+        TEST_ASSERT_TRUE(vmSetOutputSize(pVM, 0));
+
+        /* TYPE of a string that isn't null terminated leaves HERE alone */
+        here = (char *)vmGetDict(pVM)->here;
+        here[0] = '#';
+        nOutCalls = 0; outText[0] = '\0';
+        stackPushPtr(pVM->pStack, "helloX");
+        stackPushINT(pVM->pStack, 5);
+        ficlEvaluate(pVM, "type");
+        TEST_ASSERT_EQUAL_INT(1, nOutCalls);
+        TEST_ASSERT_EQUAL_STRING("hello", outText);
+        TEST_ASSERT_EQUAL_INT('#', here[0]);
+
+        nOutCalls = 0; outText[0] = '\0';
+        ficlEvaluate(pVM, ".( abc) : t .\" def\" 12 . ; t");
+        TEST_ASSERT_EQUAL_STRING("abcdef12 ", outText);
+
+        /* a legacy textOut gets big text null terminated, in pieces */
+        memset(big, 'y', sizeof (big));
+        vmSetTextOut(pVM, countTextOut);
+        TEST_ASSERT_NULL(pVM->textOutN);
+        nOutCalls = 0; outText[0] = '\0';
+        vmTextOutN(pVM, big, sizeof (big), false);
+        TEST_ASSERT_EQUAL_INT((sizeof (big) + nPAD - 2) / (nPAD - 1), nOutCalls);
+        TEST_ASSERT_EQUAL_INT(sizeof (big), strlen(outText));
+
+        ficlTermSystem(pSys);
+    }
+
+    /* hands out the NUL-terminated string at pRefillCtx 7 bytes at a time */
+    static int nRefills;
+    static FICL_INT trickleRefill(FICL_VM *pVM, char *buf, size_t size)
+    {
+        const char **ppText = (const char **)pVM->pRefillCtx;
+        size_t len = strlen(*ppText);
+
+        nRefills++;
+        if (len > 7)
+            len = 7;
+        if (len > size)
+            len = size;
+        memcpy(buf, *ppText, len);
+        *ppText += len;
+        return (FICL_INT)len;
+    }
+
+    /* vmRefillTest - ficlExecRefill interprets text as the callback supplies it */
+    static void vmRefillTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVM(pSys);
+        const char *text  =
+            ": twice  ( n -- 2n )\n"
+            "    2 * ;\n"
+            ": skip-line  refill drop  source nip >in ! ;\r\n"
+            "21 twice  skip-line junk\n"
+            "more junk that refill skipped\n"
+            "1000000 1+";     /* no trailing newline */
+        const char *bad = "1 2 +\nno-such-word\n3 4 +\n";
+
+        vmSetRefill(pVM, trickleRefill, &text);
+        TEST_ASSERT_EQUAL_INT(VM_OUTOFTEXT, ficlExecRefill(pVM));
+        TEST_ASSERT_EQUAL_INT(2, stackDepth(pVM->pStack));
+        TEST_ASSERT_EQUAL_INT(1000001, stackPopINT(pVM->pStack));
+        TEST_ASSERT_EQUAL_INT(42, stackPopINT(pVM->pStack));
+
+        /*
+        ** an error stops the text there: the third 7 byte chunk completes
+        ** the bad line, and nothing after it is asked for
+        */
+        nRefills = 0;
+        vmSetRefill(pVM, trickleRefill, &bad);
+        TEST_ASSERT_EQUAL_INT(VM_ERREXIT, ficlExecRefill(pVM));
+        TEST_ASSERT_EQUAL_INT(0, stackDepth(pVM->pStack));
+        TEST_ASSERT_EQUAL_INT(3, nRefills);
+        TEST_ASSERT_EQUAL_STRING("4 +\n", bad);
+
+        ficlTermSystem(pSys);
+    }
+
+#if FICL_WANT_FILE && !defined(_WIN32)
+    /* filePipeReadTest - READ-LINE on a pipe leaves the rest of the stream to READ-FILE */
+    static void filePipeReadTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVM(pSys);
+        const char *text  = "first\nsecond\nthird\n";
+        ficlFILE ff;
+        int fds[2];
+
+        TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+        TEST_ASSERT_EQUAL_INT((int)strlen(text), (int)write(fds[1], text, strlen(text)));
+        close(fds[1]);
+
+        memset(&ff, 0, sizeof (ff));
+        ff.f   = fdopen(fds[0], "r");
+        ff.fam = FICL_FAM_READ;
+        TEST_ASSERT_NOT_NULL(ff.f);
+        stackPushPtr(pVM->pStack, &ff);
+        ficlEvaluate(pVM, "constant pipe-fid  create pipe-buf 16 allot");
+
+        TEST_ASSERT_EQUAL_INT(VM_OUTOFTEXT, ficlEvaluate(pVM,
+            "pipe-buf 16 pipe-fid read-line throw 2drop  pipe-buf 5 pipe-fid read-file throw"));
+        TEST_ASSERT_EQUAL_INT(5, stackPopINT(pVM->pStack));
+        ficlEvaluate(pVM, "pipe-buf");
+        TEST_ASSERT_EQUAL_MEMORY("secon", stackPopPtr(pVM->pStack), 5);
+
+        TEST_ASSERT_EQUAL_INT(VM_OUTOFTEXT, ficlEvaluate(pVM,
+            "pipe-buf 16 pipe-fid read-line throw drop"));
+        TEST_ASSERT_EQUAL_INT(1, stackPopINT(pVM->pStack));     /* "d" */
+        TEST_ASSERT_EQUAL_INT(VM_OUTOFTEXT, ficlEvaluate(pVM,
+            "pipe-buf 16 pipe-fid read-file throw"));
+        TEST_ASSERT_EQUAL_INT(6, stackPopINT(pVM->pStack));     /* "third\n" */
+
+        ficlFree(ff.rbuf);
+        fclose(ff.f);
+        ficlTermSystem(pSys);
+    }
+#endif
+
+    static int compareCells(const void *a, const void *b)
+    {
+        FICL_INT x = *(const FICL_INT *)a;
+        FICL_INT y = *(const FICL_INT *)b;
+        return (x > y) - (x < y);
+    }
+
+    /* cellKernelTest - sort and lower bound agree with qsort and a linear scan */
+    static void cellKernelTest(void)
+    {
+        static const FICL_UNS sizes[] = { 0, 1, 2, 15, 17, 255, 256, 1000, 5000 };
+        FICL_INT *p   = malloc(5000 * sizeof (FICL_INT));
+        FICL_INT *ref = malloc(5000 * sizeof (FICL_INT));
+        uint64_t seed = 0x9E3779B97F4A7C15;
+        size_t s, mode;
+        FICL_UNS i, j;
+
+        TEST_ASSERT_NOT_NULL(p);
+        TEST_ASSERT_NOT_NULL(ref);
+
+        /* full-width random, small signed range, all equal, descending */
+        for (mode = 0; mode < 4; mode++)
+        {
+            for (s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+            {
+                FICL_UNS u = sizes[s];
+                for (i = 0; i < u; i++)
+                {
+                    seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+                    p[i] = (mode == 0) ? (FICL_INT)seed
+                         : (mode == 1) ? (FICL_INT)(seed % 201) - 100
+                         : (mode == 2) ? 7 : (FICL_INT)(u - i) * -3;
+                }
+                memcpy(ref, p, u * sizeof (FICL_INT));
+                qsort(ref, u, sizeof (FICL_INT), compareCells);
+                ficlCellSort(p, u);
+                TEST_ASSERT_TRUE(memcmp(p, ref, u * sizeof (FICL_INT)) == 0);
+
+                for (i = 0; i < 50; i++)
+                {
+                    FICL_INT n = (u == 0) ? 0 : ref[(i * 7919) % u] + (FICL_INT)(i % 3) - 1;
+                    for (j = 0; (j < u) && (ref[j] < n); j++)
+                        ;
+                    TEST_ASSERT_TRUE(ficlCellLowerBound(p, u, n) == j);
+                }
+            }
+        }
+
+        free(p);
+        free(ref);
+    }
+
+#if FICL_WANT_FLOAT && (FICL_FLOAT_BITS == 64)
+    /* parse text as a ficl float literal and return the bits */
+    static uint64_t parseFloatBits(FICL_VM *pVM, const char *text)
+    {
+        STRINGINFO si;
+        FICL_FLOAT f;
+        uint64_t bits;
+
+        SI_SETPTR(si, text);
+        SI_SETLEN(si, strlen(text));
+        TEST_ASSERT_TRUE(ficlParseFloatNumber(pVM, si));
+        f = stackPopFloat(pVM->fStack);
+        memcpy(&bits, &f, sizeof (bits));
+        return bits;
+    }
+
+    static uint64_t strtodBits(const char *text)
+    {
+        double d = strtod(text, NULL);
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof (bits));
+        return bits;
+    }
+
+    /* floatParseTest - literals round to the same double as strtod, shortest and long forms */
+    static void floatParseTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVM(pSys);
+        static const char *edge[] =
+        {
+            "0.1e0", "1e23", "1.7976931348623157e308", "1.7976931348623159e308",
+            "4.9406564584124654e-324", "2.4703282292062328e-324", "2.2250738585072011e-308",
+            "9007199254740993e0", "9007199254740993.0000000000000000000000001e0",
+            "7.2057594037927933e16", "123456789012345678901234567890e0", "1e-400", "1e400",
+        };
+        uint64_t seed = 0x9E3779B97F4A7C15;
+        char buf[64];
+        size_t i;
+
+        for (i = 0; i < sizeof (edge) / sizeof (edge[0]); i++)
+            TEST_ASSERT_TRUE(parseFloatBits(pVM, edge[i]) == strtodBits(edge[i]));
+
+        /* random bit patterns printed to 17 digits must come back exactly */
+        for (i = 0; i < 20000; i++)
+        {
+            double d;
+            seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+            memcpy(&d, &seed, sizeof (d));
+            if ((d != d) || (d - d != 0))
+                continue;       /* no literal for NaN or infinity */
+            snprintf(buf, sizeof (buf), "%.*e", (int)(i % 18), d);
+            TEST_ASSERT_TRUE(parseFloatBits(pVM, buf) == strtodBits(buf));
+            if (i % 18 == 16)
+                TEST_ASSERT_TRUE(parseFloatBits(pVM, buf) == seed);
+        }
+
+        ficlTermSystem(pSys);
+    }
+
+    /* floatFormatTest - f.rt prints the shortest digits that read back to the same double */
+    static void floatFormatTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVM(pSys);
+        uint64_t seed = 0x2545F4914F6CDD1D;
+        size_t i;
+
+        vmSetTextOutN(pVM, lenTextOut);
+
+        outText[0] = '\0';
+        ficlEvaluate(pVM, "0.1e f.rt 1e23 f.rt -2.5e-7 f.rt 5e-324 f.rt 0.3e 0.1e f- f.rt");
+        TEST_ASSERT_EQUAL_STRING("1e-01 1e+23 -2.5e-07 5e-324 1.9999999999999998e-01 ", outText);
+
+        outText[0] = '\0';
+        ficlEvaluate(pVM, "0 set-precision 0.3e f. 123456.789e f. 1e20 f. 1.5e-5 f. 1e fe. 6 set-precision");
+        TEST_ASSERT_EQUAL_STRING("0.3 123456.789 1e+20 1.5e-05 1.e+00 ", outText);
+
+        for (i = 0; i < 20000; i++)
+        {
+            double d;
+            size_t len;
+            seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+            memcpy(&d, &seed, sizeof (d));
+            if ((d != d) || (d - d != 0))
+                continue;
+            outText[0] = '\0';
+            stackPushFloat(pVM->fStack, d);
+            ficlEvaluate(pVM, "f.rt");
+            len = strlen(outText);
+            TEST_ASSERT_TRUE(len > 1 && outText[len - 1] == ' ');
+            outText[len - 1] = '\0';
+            TEST_ASSERT_TRUE(parseFloatBits(pVM, outText) == seed);
+        }
+
+        ficlTermSystem(pSys);
+    }
+#endif
+
+#if FICL_WANT_GUARD_PAGES
+    /* vmGuardPageTest - runaway return stack traps in a guard page, VM survives */
+    static void vmGuardPageTest(void)
+    {
+        FICL_SYSTEM *pSys = ficlInitSystem(20000);
+        FICL_VM    *pVM   = ficlNewVM(pSys);
+
+        ficlEvaluate(pVM, ": rdeep  BEGIN 1 >r AGAIN ;");
+        ficlEvaluate(pVM, ": rshallow  BEGIN r> drop AGAIN ;");
+
+        TEST_ASSERT_EQUAL_INT_MESSAGE(VM_ERREXIT, ficlEvaluate(pVM, "rdeep"),
+            "return stack overflow should throw");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(VM_ERREXIT, ficlEvaluate(pVM, "rshallow"),
+            "return stack underflow should throw");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(VM_OUTOFTEXT, ficlEvaluate(pVM, "1 2 + drop"),
+            "VM should be usable after a guard page fault");
+
+        ficlTermSystem(pSys);
+    }
+#endif
+
 #if FICL_WANT_INTERRUPT
     /* vmInterruptBeginAgainTest - interrupt a BEGIN AGAIN loop via vmInterrupt */
     static void vmInterruptBeginAgainTest(void)
@@ -1204,6 +1712,24 @@ int main(int argc, char **argv)
         RUN_TEST(wordAppendBodyTest);
         RUN_TEST(hashLayoutTest);
         RUN_TEST(hashCreateTest);
+        RUN_TEST(vmArenaLayoutTest);
+        RUN_TEST(heapStatsTest);
+        RUN_TEST(heapHostAllocatorTest);
+        RUN_TEST(allocRegionTest);
+        RUN_TEST(vmOutputBufferTest);
+        RUN_TEST(vmTextOutNTest);
+        RUN_TEST(vmRefillTest);
+#if FICL_WANT_FILE && !defined(_WIN32)
+        RUN_TEST(filePipeReadTest);
+#endif
+        RUN_TEST(cellKernelTest);
+#if FICL_WANT_FLOAT && (FICL_FLOAT_BITS == 64)
+        RUN_TEST(floatParseTest);
+        RUN_TEST(floatFormatTest);
+#endif
+#if FICL_WANT_GUARD_PAGES
+        RUN_TEST(vmGuardPageTest);
+#endif
 #if FICL_WANT_INTERRUPT
         RUN_TEST(vmInterruptBeginAgainTest);
         RUN_TEST(vmInterruptDoLoopTest);
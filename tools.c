@@ -222,6 +222,21 @@ static void seeColon(FICL_VM *pVM, CELL *pc)
                     snprintf(cp, SNLIMIT, "c\" %.*s\"", sp->count, sp->text);
                 }
                 break;
+#if FICL_WANT_OOP
+            case METHOD:
+                {
+                    FICL_STRING *sp = (FICL_STRING *)(void *)(pc + 1 + FICL_METHOD_CACHE_CELLS);
+                    pc = (CELL *)alignPtr(sp->text + sp->count + 1) - 1;
+                    snprintf(cp, SNLIMIT, "%.*s %.*s", pFW->nName, pFW->name, sp->count, sp->text);
+                }
+                break;
+#if FICL_WANT_VCALL
+            case VCALL:
+                c = *++pc;
+                snprintf(cp, SNLIMIT, "(vcall) slot " PCT_LD, c.i);
+                break;
+#endif
+#endif
             case IF:
                 c = *++pc;
                 if (c.i > 0)
@@ -479,7 +494,6 @@ static void stepBreak(FICL_VM *pVM)
     STRINGINFO si;
     FICL_WORD *pFW;
     FICL_WORD *pOnStep;
-    char outbuf[nPAD];
 
     if (!pVM->fRestart)
     {
@@ -504,15 +518,8 @@ static void stepBreak(FICL_VM *pVM)
         ** Print the name of the next instruction
         */
         pFW = pVM->pSys->bpStep.origXT;
-        snprintf(outbuf, sizeof(outbuf), "next: %.*s", pFW->nName, pFW->name);
-#if 0
-        if (isPrimitive(pFW))
-        {
-            strcat(outbuf, " ( primitive )");
-        }
-#endif
-
-        vmTextOut(pVM, outbuf, true);
+        vmTextOut(pVM, "next: ", false);
+        vmTextOutN(pVM, pFW->name, pFW->nName, true);
         debugPrompt(pVM);
     }
     else
@@ -626,8 +633,9 @@ static void displayPStack(FICL_VM *pVM)
         pCell = pStk->base;
         for (i = 0; i < d; i++)
         {
-            vmTextOut(pVM, ficlLtoa((*pCell++).i, outbuf, pVM->base), false);
-            vmTextOut(pVM, " ", false);
+            size_t len = strlen(ficlLtoa((*pCell++).i, outbuf, pVM->base));
+            outbuf[len++] = ' ';
+            vmTextOutN(pVM, outbuf, len, false);
         }
     }
     return;
@@ -670,8 +678,9 @@ static void displayRStack(FICL_VM *pVM)
                     continue;  /* no need to print the numeric value */
                 }
             }
-            vmTextOut(pVM, ficlLtoa(c.i, outbuf, pVM->base), false);
-            vmTextOut(pVM, " ", false);
+            size_t len = strlen(ficlLtoa(c.i, outbuf, pVM->base));
+            outbuf[len++] = ' ';
+            vmTextOutN(pVM, outbuf, len, false);
         }
     }
 
@@ -859,12 +868,12 @@ static void env2Constant(FICL_VM *pVM)
 
 /**************************************************************************
                         b u f T e x t O u t
-** Replacement OUTFUNC used by >buf.
-** Appends text (and optionally a newline) to the null-terminated buffer
-** at pVM->pExtend. The caller is responsible for ensuring the buffer
-** is large enough.
+** Replacement OUTFUNCN used by >buf.
+** Appends len bytes of text (and optionally a newline) to the
+** null-terminated buffer at pVM->pExtend. The caller is responsible
+** for ensuring the buffer is large enough.
 **************************************************************************/
-static void bufTextOut(FICL_VM *pVM, char *text, bool fNewline)
+static void bufTextOut(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
 {
     char *buf = (char *)pVM->pExtend;
     if (!buf)
@@ -873,7 +882,6 @@ static void bufTextOut(FICL_VM *pVM, char *text, bool fNewline)
     char *end = buf + strlen(buf);
     if (text)
     {
-        size_t len = strlen(text);
         memcpy(end, text, len);
         end += len;
     }
@@ -887,14 +895,14 @@ static void bufTextOut(FICL_VM *pVM, char *text, bool fNewline)
                         t o B u f
 ** >buf ( xt c-addr -- )
 ** Ficl extra -- Scripted test helper word
-** Redirects textOut to the buffer at c-addr, execute xt to completion,
-** then restores the previous textOut and pExtend.
+** Redirects textOutN to the buffer at c-addr, execute xt to completion,
+** then restores the previous textOutN and pExtend.
 ** c-addr must point to a writable buffer large enough to hold all output
 ** produced by xt. The buffer is initialised to empty before xt runs.
 **************************************************************************/
 static void toBuf(FICL_VM *pVM)
 {
-    OUTFUNC    savedTextOut = pVM->textOut;
+    OUTFUNCN   savedTextOut = pVM->textOutN;
     void      *savedExtend  = pVM->pExtend;
     char      *buf          = (char *)POPPTR();      /* c-addr -- top of stack */
     FICL_WORD *xt           = (FICL_WORD *)POPPTR(); /* xt -- below c-addr */
@@ -902,12 +910,14 @@ static void toBuf(FICL_VM *pVM)
     if (buf)
         buf[0] = '\0';   /* initialise buffer to empty string */
 
+    vmFlushOutput(pVM);
     pVM->pExtend = buf;
-    pVM->textOut = (OUTFUNC) bufTextOut;
+    pVM->textOutN = bufTextOut;
 
     ficlExecXT(pVM, xt);
 
-    pVM->textOut = savedTextOut;
+    vmFlushOutput(pVM);
+    pVM->textOutN = savedTextOut;
     pVM->pExtend = savedExtend;
 }
 
@@ -57,6 +57,14 @@
 #include <float.h>
 #include <math.h>
 #include "dpmath.h"
+#if FICL_WANT_GUARD_PAGES
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#if FICL_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 
 #if FICL_ROBUST > 1
     #define VM_CHECK_STACK_LOCAL(pop, push) \
@@ -922,6 +930,45 @@
         goto OP_DONE; \
     }
 
+/*
+** Loop index words. The DO frame on the return stack is
+** (leave-ip limit index), so I, J and K are 1, 4 and 7 cells down.
+** None of these touch ip, so vmExecute can run them too. The fused
+** forms are compiled by ficlParseWord in place of I +, I CELLS and
+** I CELLS +.
+*/
+#define VM_OP_CASES_LOOP(OP_DONE) \
+    case FICL_OP_LOOP_I: { \
+        VM_CHECK_STACK_LOCAL(0, 1); \
+        *dataTop++ = pVM->rStack->sp[-1]; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_LOOP_J: { \
+        VM_CHECK_STACK_LOCAL(0, 1); \
+        *dataTop++ = pVM->rStack->sp[-4]; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_LOOP_K: { \
+        VM_CHECK_STACK_LOCAL(0, 1); \
+        *dataTop++ = pVM->rStack->sp[-7]; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_I_PLUS: { \
+        VM_CHECK_STACK_LOCAL(1, 1); \
+        dataTop[-1].i += pVM->rStack->sp[-1].i; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_I_CELLS: { \
+        VM_CHECK_STACK_LOCAL(0, 1); \
+        (dataTop++)->i = pVM->rStack->sp[-1].i * (FICL_INT)sizeof (CELL); \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_I_CELLS_PLUS: { \
+        VM_CHECK_STACK_LOCAL(1, 1); \
+        dataTop[-1].i += pVM->rStack->sp[-1].i * (FICL_INT)sizeof (CELL); \
+        goto OP_DONE; \
+    }
+
 #define VM_OP_CASES_WORD(OP_DONE) \
     case FICL_OP_CONSTANT: { \
         VM_CHECK_STACK_LOCAL(0, 1); \
@@ -956,6 +1003,246 @@
 #define VM_OP_CASES_USER(OP_DONE)
 #endif
 
+/*
+** Locals live in a frame on the return stack: (link) pushes the old
+** pFrame and reserves the cells that follow, (unlink) drops them again.
+** Local indexes other than 0 and 1 follow the opcode in the code stream.
+*/
+#if FICL_WANT_LOCALS
+#define VM_OP_CASES_LOCALS(OP_DONE) \
+    case FICL_OP_LINK: { \
+        FICL_STACK *_rs = pVM->rStack; \
+        (_rs->sp++)->p = _rs->pFrame; \
+        _rs->pFrame = _rs->sp; \
+        _rs->sp += *(FICL_INT *)ip; \
+        ip += 1; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_UNLINK: { \
+        FICL_STACK *_rs = pVM->rStack; \
+        _rs->sp = _rs->pFrame; \
+        _rs->pFrame = (CELL *)(--_rs->sp)->p; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_GET_LOCAL: { \
+        VM_CHECK_STACK_LOCAL(0, 1); \
+        *dataTop++ = pVM->rStack->pFrame[*(FICL_INT *)ip]; \
+        ip += 1; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_TO_LOCAL: { \
+        VM_CHECK_STACK_LOCAL(1, 0); \
+        pVM->rStack->pFrame[*(FICL_INT *)ip] = *--dataTop; \
+        ip += 1; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_GET_LOCAL0: { \
+        VM_CHECK_STACK_LOCAL(0, 1); \
+        *dataTop++ = pVM->rStack->pFrame[0]; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_TO_LOCAL0: { \
+        VM_CHECK_STACK_LOCAL(1, 0); \
+        pVM->rStack->pFrame[0] = *--dataTop; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_GET_LOCAL1: { \
+        VM_CHECK_STACK_LOCAL(0, 1); \
+        *dataTop++ = pVM->rStack->pFrame[1]; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_TO_LOCAL1: { \
+        VM_CHECK_STACK_LOCAL(1, 0); \
+        pVM->rStack->pFrame[1] = *--dataTop; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_GET_2LOCAL: { \
+        CELL *_lp; \
+        VM_CHECK_STACK_LOCAL(0, 2); \
+        _lp = pVM->rStack->pFrame + *(FICL_INT *)ip; \
+        dataTop[0] = _lp[0]; \
+        dataTop[1] = _lp[1]; \
+        dataTop += 2; \
+        ip += 1; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_TO_2LOCAL: { \
+        CELL *_lp; \
+        VM_CHECK_STACK_LOCAL(2, 0); \
+        _lp = pVM->rStack->pFrame + *(FICL_INT *)ip; \
+        dataTop -= 2; \
+        _lp[0] = dataTop[0]; \
+        _lp[1] = dataTop[1]; \
+        ip += 1; \
+        goto OP_DONE; \
+    } \
+    VM_OP_CASES_FLOCALS(OP_DONE)
+
+#if FICL_WANT_FLOAT
+#define VM_OP_CASES_FLOCALS(OP_DONE) \
+    case FICL_OP_GET_FLOCAL: { \
+        VM_CHECK_FSTACK_LOCAL(0, 1); \
+        memcpy(floatTop++, pVM->rStack->pFrame + *(FICL_INT *)ip, sizeof (FICL_FLOAT)); \
+        ip += 1; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_TO_FLOCAL: { \
+        VM_CHECK_FSTACK_LOCAL(1, 0); \
+        memcpy(pVM->rStack->pFrame + *(FICL_INT *)ip, --floatTop, sizeof (FICL_FLOAT)); \
+        ip += 1; \
+        goto OP_DONE; \
+    }
+#else
+#define VM_OP_CASES_FLOCALS(OP_DONE)
+#endif
+#else
+#define VM_OP_CASES_LOCALS(OP_DONE)
+#endif
+
+/*
+** Late-bound method calls. The call site is followed by an inline cache
+** (see ficlLookupMethod in words.c) and the method name. A hit on the most
+** recent class costs one compare; colon and DOES> methods are then entered,
+** and instance variable members evaluated, without leaving the inner loop.
+** Anything else goes through vmExecute with the cached stack pointers
+** written back.
+*/
+#if FICL_WANT_OOP
+#if FICL_WANT_FLOAT
+#define VM_SAVE_FLOAT_TOP(pVM) ((pVM)->fStack->sp = floatTop)
+#define VM_LOAD_FLOAT_TOP(pVM) (floatTop = (pVM)->fStack->sp)
+#else
+#define VM_SAVE_FLOAT_TOP(pVM) ((void)0)
+#define VM_LOAD_FLOAT_TOP(pVM) ((void)0)
+#endif
+
+#define VM_METHOD_LOOKUP(xt) \
+    do { \
+        CELL *_cache = (CELL *)ip; \
+        FICL_STRING *_sp = (FICL_STRING *)(_cache + FICL_METHOD_CACHE_CELLS); \
+        VM_CHECK_STACK_LOCAL(2, 0); \
+        ip = (IPTYPE)(void *)alignPtr(_sp->text + _sp->count + 1); \
+        if (_cache[0].u == ficlHashEpoch && _cache[1].p == dataTop[-1].p) \
+            (xt) = (FICL_WORD *)_cache[2].p; \
+        else { \
+            STRINGINFO _si; \
+            SI_PFS(_si, _sp); \
+            pVM->pStack->sp = dataTop; \
+            pVM->ip = ip; \
+            (xt) = ficlLookupMethod(pVM, _cache, dataTop[-1].p, _si); \
+        } \
+    } while (0)
+
+/*
+** Enter method xt for the ( instance class ) on top of the stack.
+*/
+#define VM_METHOD_ENTER(xt) \
+    do { \
+        if ((xt)->opcode == FICL_OP_COLON) { \
+            *pVM->rStack->sp++ = (CELL){.p = ip}; \
+            ip = (IPTYPE)((xt)->param); \
+        } else if ((xt)->opcode == FICL_OP_DOES) { \
+            VM_CHECK_STACK_LOCAL(0, 1); \
+            (dataTop++)->p = (xt)->param + 1; \
+            *pVM->rStack->sp++ = (CELL){.p = ip}; \
+            ip = (IPTYPE)((xt)->param[0].p); \
+        } else if ((xt)->opcode == FICL_OP_IVAR) { \
+            dataTop--; \
+            dataTop[-1].p = (char *)dataTop[-1].p + (xt)->param[1].i; \
+        } else if ((xt)->opcode == FICL_OP_AGGREGATE) { \
+            dataTop[-2].p = (char *)dataTop[-2].p + (xt)->param[1].i; \
+            dataTop[-1] = (xt)->param[2]; \
+        } else { \
+            pVM->pStack->sp = dataTop; \
+            VM_SAVE_FLOAT_TOP(pVM); \
+            pVM->ip = ip; \
+            vmExecute(pVM, (xt)); \
+            dataTop = pVM->pStack->sp; \
+            VM_LOAD_FLOAT_TOP(pVM); \
+            ip = pVM->ip; \
+        } \
+    } while (0)
+
+/*
+** Virtual calls compiled by ==>: the slot number follows (vcall) inline,
+** and the method is two loads away - the class's vtable, then the slot.
+** Stale tables and out-of-range slots go through ficlVtableLookup; the
+** receiver's class is not checked against the call site's.
+*/
+#if FICL_WANT_VCALL
+#define VM_VTABLE_LOOKUP(xt) \
+    do { \
+        FICL_UNS _slot = *(FICL_UNS *)ip; \
+        CELL *_vt; \
+        VM_CHECK_STACK_LOCAL(2, 0); \
+        ip += 1; \
+        _vt = (CELL *)((CELL *)dataTop[-1].p)[FICL_CLASS_VTABLE].p; \
+        if (_vt != NULL && _slot < _vt[FICL_VTABLE_COUNT].u \
+                && _vt[FICL_VTABLE_EPOCH].u == ficlVtableEpoch) \
+            (xt) = (FICL_WORD *)_vt[FICL_VTABLE_XT + _slot].p; \
+        else { \
+            pVM->pStack->sp = dataTop; \
+            pVM->ip = ip; \
+            (xt) = ficlVtableLookup(pVM, dataTop[-1].p, _slot); \
+        } \
+    } while (0)
+
+#define VM_OP_CASES_VCALL(OP_DONE) \
+    case FICL_OP_VCALL: { \
+        FICL_WORD *_xt; \
+        VM_VTABLE_LOOKUP(_xt); \
+        VM_METHOD_ENTER(_xt); \
+        goto OP_DONE; \
+    }
+#else
+#define VM_OP_CASES_VCALL(OP_DONE)
+#endif
+
+#define VM_OP_CASES_OOP(OP_DONE) \
+    case FICL_OP_METHOD: { \
+        FICL_WORD *_xt; \
+        VM_METHOD_LOOKUP(_xt); \
+        VM_METHOD_ENTER(_xt); \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_METHOD_XT: { \
+        FICL_WORD *_xt; \
+        VM_METHOD_LOOKUP(_xt); \
+        VM_CHECK_STACK_LOCAL(0, 1); \
+        (dataTop++)->p = _xt; \
+        goto OP_DONE; \
+    } \
+    VM_OP_CASES_VCALL(OP_DONE)
+
+/*
+** Instance variable words made by oo.fr. Same body layout as the DOES>
+** words they replace: param[1] is the member offset, param[2] the member
+** class for obj:, array: and ref: members.
+*/
+#define VM_OP_CASES_OBJECT(OP_DONE) \
+    case FICL_OP_IVAR: { \
+        VM_CHECK_STACK_LOCAL(2, 1); \
+        dataTop--; \
+        dataTop[-1].p = (char *)dataTop[-1].p + pWord->param[1].i; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_AGGREGATE: { \
+        VM_CHECK_STACK_LOCAL(2, 2); \
+        dataTop[-2].p = (char *)dataTop[-2].p + pWord->param[1].i; \
+        dataTop[-1] = pWord->param[2]; \
+        goto OP_DONE; \
+    } \
+    case FICL_OP_REF: { \
+        VM_CHECK_STACK_LOCAL(2, 2); \
+        dataTop[-2].p = *(void **)((char *)dataTop[-2].p + pWord->param[1].i); \
+        dataTop[-1] = pWord->param[2]; \
+        goto OP_DONE; \
+    }
+#else
+#define VM_OP_CASES_OOP(OP_DONE)
+#define VM_OP_CASES_OBJECT(OP_DONE)
+#endif
+
 #define VM_OP_SWITCH_INNER(OP_DONE) \
     switch (opcode) { \
         VM_OP_CASES_BASE(OP_DONE) \
@@ -963,6 +1250,10 @@
         VM_OP_CASES_WORD(OP_DONE) \
         VM_OP_CASES_USER(OP_DONE) \
         VM_OP_CASES_IP(OP_DONE) \
+        VM_OP_CASES_LOOP(OP_DONE) \
+        VM_OP_CASES_LOCALS(OP_DONE) \
+        VM_OP_CASES_OOP(OP_DONE) \
+        VM_OP_CASES_OBJECT(OP_DONE) \
         default: \
             break; \
     }
@@ -986,146 +1277,518 @@ void vmBranchRelative(FICL_VM *pVM, int offset)
 ** Creates a virtual machine either from scratch (if pVM is NULL on entry)
 ** or by resizing and reinitializing an existing VM to the specified stack
 ** sizes.
+** A VM created from scratch lives in a single allocation laid out as
+**
+**   | FICL_VM | outBuf | pStack | guard | rStack | guard | fStack | guard |
+**
+** so the hot VM fields and stack pointers share cache lines and creating
+** a VM costs one ficlMalloc. Each guard gap is FICL_STACK_GUARD cells of
+** fill pattern (see vmCheckGuards). Resizing an existing VM falls back to
+** separately allocated stacks, since the arena can't grow in place.
+** outBuf is the default FICL_OUTBUF_SIZE output buffer (see vmTextOut).
 **************************************************************************/
-FICL_VM *vmCreate(FICL_VM *pVM, unsigned nPStack, unsigned nRStack)
-{
-    if (pVM == NULL)
-    {
-        pVM = (FICL_VM *)ficlMalloc(sizeof (FICL_VM));
-        assert (pVM);
-        memset(pVM, 0, sizeof (FICL_VM));
-    }
+#define VM_ARENA_ALIGN  16
+#define VM_ALIGN(n)     (((n) + VM_ARENA_ALIGN - 1) & ~(size_t)(VM_ARENA_ALIGN - 1))
+#define VM_GUARD_BYTES  VM_ALIGN(FICL_STACK_GUARD * sizeof (CELL))
+#define VM_GUARD_FILL   0xA5
 
-    if (pVM->pStack)
-        stackDelete(pVM->pStack);
-    pVM->pStack = stackCreate(nPStack);
+static bool vmInArena(FICL_VM *pVM, const void *p)
+{
+    const char *cp = (const char *)p;
+    return (cp > (const char *)pVM) && (cp < (const char *)pVM + pVM->arenaBytes);
+}
 
-    if (pVM->rStack)
-        stackDelete(pVM->rStack);
-    pVM->rStack = stackCreate(nRStack);
+#if !FICL_WANT_GUARD_PAGES
+/*
+** The guard for a stack runs from the end of its last cell (including any
+** alignment padding) to the start of the next stack in the arena.
+*/
+static void vmGuardRange(const void *pEnd, size_t nBytes, unsigned char **ppGuard, size_t *pSize)
+{
+    *ppGuard = (unsigned char *)pEnd;
+    *pSize = VM_ALIGN(nBytes) - nBytes + VM_GUARD_BYTES;
+}
 
+static FICL_VM *vmCreateArena(unsigned nPStack, unsigned nRStack)
+{
+    size_t vmBytes = VM_ALIGN(sizeof (FICL_VM)) + VM_ALIGN(FICL_OUTBUF_SIZE);
+    size_t pBytes  = VM_ALIGN(FICL_STACK_BYTES(nPStack));
+    size_t rBytes  = VM_ALIGN(FICL_STACK_BYTES(nRStack));
 #if FICL_WANT_FLOAT
-    if (pVM->fStack)
-        stackDeleteFloat(pVM->fStack);
-    pVM->fStack = stackCreateFloat(nPStack);
-    pVM->fPrecision = 5; /* default float output precision */
+    size_t fBytes  = VM_ALIGN(FICL_FSTACK_BYTES(nPStack));
+#else
+    size_t fBytes  = 0;
+#endif
+    size_t size = vmBytes + pBytes + rBytes + fBytes + 3 * VM_GUARD_BYTES;
+    unsigned char *pGuard;
+    size_t nGuard;
+    char *cp;
+    FICL_VM *pVM;
+
+#if FICL_ROBUST
+    assert (nPStack != 0);
+    assert (nRStack != 0);
 #endif
 
-    pVM->textOut = ficlTextOut;
+    cp = (char *)ficlMalloc(size);
+    assert (cp);
+    memset(cp, 0, vmBytes);
+    pVM = (FICL_VM *)cp;
+    pVM->arenaBytes = size;
+#if FICL_OUTBUF_SIZE > 0
+    pVM->outBuf  = cp + VM_ALIGN(sizeof (FICL_VM));
+    pVM->outSize = FICL_OUTBUF_SIZE;
+#endif
+    cp += vmBytes;
 
-    vmReset(pVM);
-    return pVM;
-}
+    pVM->pStack = (FICL_STACK *)cp;
+    pVM->pStack->nCells = nPStack;
+    vmGuardRange(pVM->pStack->base + nPStack, FICL_STACK_BYTES(nPStack), &pGuard, &nGuard);
+    memset(pGuard, VM_GUARD_FILL, nGuard);
+    cp += pBytes + VM_GUARD_BYTES;
 
+    pVM->rStack = (FICL_STACK *)cp;
+    pVM->rStack->nCells = nRStack;
+    vmGuardRange(pVM->rStack->base + nRStack, FICL_STACK_BYTES(nRStack), &pGuard, &nGuard);
+    memset(pGuard, VM_GUARD_FILL, nGuard);
+    cp += rBytes + VM_GUARD_BYTES;
 
-/**************************************************************************
-                        v m D e l e t e
-** Free all memory allocated to the specified VM and its subordinate
-** structures.
-**************************************************************************/
-void vmDelete (FICL_VM *pVM)
-{
-    if (pVM)
-    {
-        ficlFree(pVM->pStack);
-        ficlFree(pVM->rStack);
 #if FICL_WANT_FLOAT
-        stackDeleteFloat(pVM->fStack);
+    pVM->fStack = (FICL_FSTACK *)cp;
+    pVM->fStack->nCells = nPStack;
+    vmGuardRange(pVM->fStack->base + nPStack, FICL_FSTACK_BYTES(nPStack), &pGuard, &nGuard);
+    memset(pGuard, VM_GUARD_FILL, nGuard);
+#else
+    memset(cp, VM_GUARD_FILL, VM_GUARD_BYTES);
 #endif
-        ficlFree(pVM);
-    }
 
-    return;
+    return pVM;
 }
+#endif /* !FICL_WANT_GUARD_PAGES */
 
-
+#if FICL_WANT_GUARD_PAGES
 /**************************************************************************
-                        v m E x e c u t e
-** Sets up the specified word to be run by the inner interpreter.
-** Executes the word's code part immediately, but in the case of
-** colon definition, the definition itself needs the inner interp
-** to complete. This does not happen until control reaches ficlExec
+                        g u a r d   p a g e s
+** With FICL_WANT_GUARD_PAGES, vmCreate maps each VM with mmap and gives
+** every stack a PROT_NONE page on either side:
+**
+**   | FICL_VM | G | pStack | G | G | rStack | G | G | fStack | G |
+**
+** Each stack is sized up to whole pages so that base[nCells] is the first
+** byte of its upper guard. A SIGSEGV (or SIGBUS) in a lower guard is an
+** underflow, in an upper guard an overflow; the handler throws on the
+** owning VM. Faults outside any VM's guards go to the previous handler.
+** Note: the list of guarded VMs is not locked - create and delete VMs
+** from one thread if you use this mode.
 **************************************************************************/
-void vmExecute(FICL_VM *pVM, FICL_WORD *pWord)
+static FICL_VM *guardList = NULL;
+static size_t pageSize = 0;
+static struct sigaction oldSegv;
+static struct sigaction oldBus;
+
+#define VM_PAGE_ROUND(n) (((n) + pageSize - 1) & ~(pageSize - 1))
+
+/*
+** Returns -1 if addr lies in the lower guard page of the stack that
+** starts at pStack and occupies nBytes, +1 if in the upper guard, else 0
+*/
+static int vmGuardHit(const char *addr, const void *pStack, size_t nBytes)
 {
-    pVM->runningWord = pWord;
-    if (pWord->opcode != FICL_OP_CALL)
+    const char *lo = (const char *)pStack;
+    const char *hi = lo + VM_PAGE_ROUND(nBytes);
+
+    if ((addr >= lo - pageSize) && (addr < lo))
+        return -1;
+    if ((addr >= hi) && (addr < hi + pageSize))
+        return 1;
+    return 0;
+}
+
+static void vmGuardFault(int sig, siginfo_t *si, void *context)
+{
+    const char *addr = (const char *)si->si_addr;
+    struct sigaction *pOld = (sig == SIGBUS) ? &oldBus : &oldSegv;
+    FICL_VM *pVM;
+    int hit;
+
+    for (pVM = guardList; pVM != NULL; pVM = pVM->guardLink)
     {
-        CELL *dataTop = pVM->pStack->sp;
-        CELL *returnTop = pVM->rStack->sp;
-#if FICL_WANT_FLOAT
-        FICL_FLOAT *floatTop = pVM->fStack->sp;
-#endif
-        FICL_INT i;
-        FICL_UNS u;
-        CELL c, c2;
-        FICL_OPCODE opcode = pWord->opcode;
+        if ((addr < (const char *)pVM) || (addr >= (const char *)pVM + pVM->arenaBytes))
+            continue;
+        if (pVM->pState == NULL)
+            break;
 
-        switch (opcode) {
-            VM_OP_CASES_BASE(OP_DONE)
-            VM_OP_CASES_FLOAT(OP_DONE)
-            VM_OP_CASES_WORD(OP_DONE)
-            VM_OP_CASES_USER(OP_DONE)
-            case FICL_OP_COLON: {
-                (returnTop++)->p = pVM->ip;
-                pVM->ip = (IPTYPE)(pWord->param);
-                goto OP_DONE;
-            }
-            case FICL_OP_DOES: {
-                (dataTop++)->p = pWord->param + 1;
-                (returnTop++)->p = pVM->ip;
-                pVM->ip = (IPTYPE)(pWord->param[0].p);
-                goto OP_DONE;
-            }
-            default:
-                goto CALL_FALLBACK;
+        if (vmInArena(pVM, pVM->pStack)
+            && (hit = vmGuardHit(addr, pVM->pStack, FICL_STACK_BYTES(pVM->pStack->nCells))) != 0)
+        {
+            if (hit < 0)
+                vmThrowUnderflow(pVM);
+            vmThrowOverflow(pVM);
+        }
+
+        if (vmInArena(pVM, pVM->rStack)
+            && (hit = vmGuardHit(addr, pVM->rStack, FICL_STACK_BYTES(pVM->rStack->nCells))) != 0)
+        {
+            vmThrowErr(pVM, (hit < 0) ? "Error: return stack underflow"
+                                      : "Error: return stack overflow");
         }
 
-OP_DONE:
-        pVM->pStack->sp = dataTop;
-        pVM->rStack->sp = returnTop;
 #if FICL_WANT_FLOAT
-        pVM->fStack->sp = floatTop;
+        if (vmInArena(pVM, pVM->fStack)
+            && (hit = vmGuardHit(addr, pVM->fStack, FICL_FSTACK_BYTES(pVM->fStack->nCells))) != 0)
+        {
+            vmThrowErr(pVM, (hit < 0) ? "Error: float stack underflow"
+                                      : "Error: float stack overflow");
+        }
 #endif
-        return;
+        break;
     }
 
-CALL_FALLBACK:
-    pWord->code(pVM);
+    /*
+    ** Not ours: hand the fault to whoever had it before. For the default
+    ** action, reinstall it and return - the faulting access repeats and
+    ** takes the default action this time.
+    */
+    if (pOld->sa_flags & SA_SIGINFO)
+        pOld->sa_sigaction(sig, si, context);
+    else if ((pOld->sa_handler != SIG_DFL) && (pOld->sa_handler != SIG_IGN))
+        pOld->sa_handler(sig);
+    else
+        sigaction(sig, pOld, NULL);
 }
 
-/**************************************************************************
-                        v m S t e p
-** Execute a single instruction.
-**************************************************************************/
-void vmStep(FICL_VM *pVM)
+static void vmGuardInit(void)
 {
-    FICL_WORD *pWord;
-    CELL *dataTop = pVM->pStack->sp;
-    /* returnTop removed - return stack accessed directly via pVM->rStack->sp for reduced register pressure */
-#if FICL_WANT_FLOAT
-    FICL_FLOAT *floatTop = pVM->fStack->sp;
-#endif
-    IPTYPE ip = pVM->ip;
-
-    FICL_INT i;
-    FICL_UNS u;
-    CELL c, c2;
-    FICL_OPCODE opcode;
+    struct sigaction sa;
 
-    pWord = *ip++;
-    pVM->runningWord = pWord;
+    if (pageSize != 0)
+        return;
 
-    opcode = pWord->opcode;
-    if (opcode != FICL_OP_CALL)
-    {
-        VM_OP_SWITCH_INNER(OP_DONE);
-    }
+    pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    memset(&sa, 0, sizeof (sa));
+    sa.sa_sigaction = vmGuardFault;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_SIGINFO;
+    sigaction(SIGSEGV, &sa, &oldSegv);
+    sigaction(SIGBUS,  &sa, &oldBus);
+}
 
-    pVM->pStack->sp = dataTop;
-    /* pVM->rStack->sp not synced - already accessed directly in operations */
-#if FICL_WANT_FLOAT
-    pVM->fStack->sp = floatTop;
+static void *vmMapPages(size_t size)
+{
+    void *p;
+#if defined(MAP_ANONYMOUS) || defined(MAP_ANON)
+  #if !defined(MAP_ANONYMOUS)
+    #define MAP_ANONYMOUS MAP_ANON
+  #endif
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#else
+    int fd = open("/dev/zero", O_RDWR);
+    assert (fd >= 0);
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+#endif
+    assert (p != MAP_FAILED);
+    return p;
+}
+
+/*
+** Stack sizes round up so that header plus cells fill whole pages
+*/
+static unsigned vmGuardCells(unsigned nCells, size_t header, size_t cellSize)
+{
+    return (unsigned)((VM_PAGE_ROUND(header + nCells * cellSize) - header) / cellSize);
+}
+
+static FICL_VM *vmCreateGuarded(unsigned nPStack, unsigned nRStack)
+{
+    unsigned nP = vmGuardCells(nPStack, offsetof(FICL_STACK, base), sizeof (CELL));
+    unsigned nR = vmGuardCells(nRStack, offsetof(FICL_STACK, base), sizeof (CELL));
+    size_t vmBytes = VM_PAGE_ROUND(VM_ALIGN(sizeof (FICL_VM)) + FICL_OUTBUF_SIZE);
+    size_t pBytes  = FICL_STACK_BYTES(nP);
+    size_t rBytes  = FICL_STACK_BYTES(nR);
+#if FICL_WANT_FLOAT
+    unsigned nF = vmGuardCells(nPStack, offsetof(FICL_FSTACK, base), sizeof (FICL_FLOAT));
+    size_t fBytes  = FICL_FSTACK_BYTES(nF);
+    int nStacks    = 3;
+#else
+    size_t fBytes  = 0;
+    int nStacks    = 2;
+#endif
+    size_t size = vmBytes + pBytes + rBytes + fBytes + 2 * nStacks * pageSize;
+    char *cp = (char *)vmMapPages(size);
+    FICL_VM *pVM = (FICL_VM *)cp;
+
+    pVM->arenaBytes = size;
+#if FICL_OUTBUF_SIZE > 0
+    pVM->outBuf  = cp + VM_ALIGN(sizeof (FICL_VM));
+    pVM->outSize = FICL_OUTBUF_SIZE;
+#endif
+    cp += vmBytes;
+
+    mprotect(cp, pageSize, PROT_NONE);
+    cp += pageSize;
+    pVM->pStack = (FICL_STACK *)cp;
+    pVM->pStack->nCells = nP;
+    cp += pBytes;
+    mprotect(cp, 2 * pageSize, PROT_NONE);
+    cp += 2 * pageSize;
+
+    pVM->rStack = (FICL_STACK *)cp;
+    pVM->rStack->nCells = nR;
+    cp += rBytes;
+    mprotect(cp, pageSize, PROT_NONE);
+    cp += pageSize;
+
+#if FICL_WANT_FLOAT
+    mprotect(cp, pageSize, PROT_NONE);
+    cp += pageSize;
+    pVM->fStack = (FICL_FSTACK *)cp;
+    pVM->fStack->nCells = nF;
+    cp += fBytes;
+    mprotect(cp, pageSize, PROT_NONE);
+#endif
+
+    pVM->guardLink = guardList;
+    guardList = pVM;
+    return pVM;
+}
+
+static void vmDeleteGuarded(FICL_VM *pVM)
+{
+    FICL_VM **ppVM;
+
+    for (ppVM = &guardList; *ppVM != NULL; ppVM = &(*ppVM)->guardLink)
+    {
+        if (*ppVM == pVM)
+        {
+            *ppVM = pVM->guardLink;
+            break;
+        }
+    }
+
+    munmap(pVM, pVM->arenaBytes);
+}
+#endif /* FICL_WANT_GUARD_PAGES */
+
+FICL_VM *vmCreate(FICL_VM *pVM, unsigned nPStack, unsigned nRStack)
+{
+    if (pVM == NULL)
+    {
+#if FICL_WANT_GUARD_PAGES
+        vmGuardInit();
+        pVM = vmCreateGuarded(nPStack, nRStack);
+#else
+        pVM = vmCreateArena(nPStack, nRStack);
+#endif
+    }
+    else
+    {
+        if (!vmInArena(pVM, pVM->pStack))
+            stackDelete(pVM->pStack);
+        pVM->pStack = stackCreate(nPStack);
+
+        if (!vmInArena(pVM, pVM->rStack))
+            stackDelete(pVM->rStack);
+        pVM->rStack = stackCreate(nRStack);
+
+#if FICL_WANT_FLOAT
+        if (!vmInArena(pVM, pVM->fStack))
+            stackDeleteFloat(pVM->fStack);
+        pVM->fStack = stackCreateFloat(nPStack);
+#endif
+    }
+
+    pVM->pStack->pFrame = NULL;
+    pVM->rStack->pFrame = NULL;
+#if FICL_WANT_FLOAT
+    pVM->fPrecision = 5; /* default float output precision */
+#endif
+
+    pVM->textOut  = ficlTextOut;
+    pVM->textOutN = ficlTextOutN;
+
+    vmReset(pVM);
+    return pVM;
+}
+
+
+/**************************************************************************
+                        v m C h e c k G u a r d s
+** Returns true if the guard gaps that follow each stack in the VM's
+** arena still hold their fill pattern. A false return means some
+** code has run a stack past its end. Stacks that were reallocated by
+** a resizing vmCreate no longer have guards and are not checked.
+**************************************************************************/
+#if !FICL_WANT_GUARD_PAGES
+static bool vmGuardIntact(const void *pEnd, size_t nBytes)
+{
+    unsigned char *pGuard;
+    size_t nGuard;
+    size_t i;
+
+    vmGuardRange(pEnd, nBytes, &pGuard, &nGuard);
+    for (i = 0; i < nGuard; i++)
+    {
+        if (pGuard[i] != VM_GUARD_FILL)
+            return false;
+    }
+
+    return true;
+}
+#endif
+
+bool vmCheckGuards(FICL_VM *pVM)
+{
+#if FICL_WANT_GUARD_PAGES
+    FICL_IGNORE(pVM);   /* guard pages police themselves */
+    return true;
+#else
+    FICL_STACK *pStack = pVM->pStack;
+    FICL_STACK *rStack = pVM->rStack;
+
+    if (vmInArena(pVM, pStack)
+        && !vmGuardIntact(pStack->base + pStack->nCells, FICL_STACK_BYTES(pStack->nCells)))
+        return false;
+
+    if (vmInArena(pVM, rStack)
+        && !vmGuardIntact(rStack->base + rStack->nCells, FICL_STACK_BYTES(rStack->nCells)))
+        return false;
+
+#if FICL_WANT_FLOAT
+    {
+        FICL_FSTACK *fStack = pVM->fStack;
+        if (vmInArena(pVM, fStack)
+            && !vmGuardIntact(fStack->base + fStack->nCells, FICL_FSTACK_BYTES(fStack->nCells)))
+            return false;
+    }
+#endif
+
+    return true;
+#endif
+}
+
+
+/**************************************************************************
+                        v m D e l e t e
+** Free all memory allocated to the specified VM and its subordinate
+** structures.
+**************************************************************************/
+void vmDelete (FICL_VM *pVM)
+{
+    if (pVM)
+    {
+        vmFlushOutput(pVM);
+        if (pVM->outBuf && !vmInArena(pVM, pVM->outBuf))
+            ficlFree(pVM->outBuf);
+        ficlRegionDelete(pVM);
+        if (!vmInArena(pVM, pVM->pStack))
+            stackDelete(pVM->pStack);
+        if (!vmInArena(pVM, pVM->rStack))
+            stackDelete(pVM->rStack);
+#if FICL_WANT_FLOAT
+        if (!vmInArena(pVM, pVM->fStack))
+            stackDeleteFloat(pVM->fStack);
+#endif
+#if FICL_WANT_GUARD_PAGES
+        vmDeleteGuarded(pVM);
+#else
+        ficlFree(pVM);
+#endif
+    }
+
+    return;
+}
+
+
+/**************************************************************************
+                        v m E x e c u t e
+** Sets up the specified word to be run by the inner interpreter.
+** Executes the word's code part immediately, but in the case of
+** colon definition, the definition itself needs the inner interp
+** to complete. This does not happen until control reaches ficlExec
+**************************************************************************/
+void vmExecute(FICL_VM *pVM, FICL_WORD *pWord)
+{
+    pVM->runningWord = pWord;
+    if (pWord->opcode != FICL_OP_CALL)
+    {
+        CELL *dataTop = pVM->pStack->sp;
+        CELL *returnTop = pVM->rStack->sp;
+#if FICL_WANT_FLOAT
+        FICL_FLOAT *floatTop = pVM->fStack->sp;
+#endif
+        FICL_INT i;
+        FICL_UNS u;
+        CELL c, c2;
+        FICL_OPCODE opcode = pWord->opcode;
+
+        switch (opcode) {
+            VM_OP_CASES_BASE(OP_DONE)
+            VM_OP_CASES_FLOAT(OP_DONE)
+            VM_OP_CASES_WORD(OP_DONE)
+            VM_OP_CASES_USER(OP_DONE)
+            VM_OP_CASES_LOOP(OP_DONE)
+            VM_OP_CASES_OBJECT(OP_DONE)
+            case FICL_OP_COLON: {
+                (returnTop++)->p = pVM->ip;
+                pVM->ip = (IPTYPE)(pWord->param);
+                goto OP_DONE;
+            }
+            case FICL_OP_DOES: {
+                (dataTop++)->p = pWord->param + 1;
+                (returnTop++)->p = pVM->ip;
+                pVM->ip = (IPTYPE)(pWord->param[0].p);
+                goto OP_DONE;
+            }
+            default:
+                goto CALL_FALLBACK;
+        }
+
+OP_DONE:
+        pVM->pStack->sp = dataTop;
+        pVM->rStack->sp = returnTop;
+#if FICL_WANT_FLOAT
+        pVM->fStack->sp = floatTop;
+#endif
+        return;
+    }
+
+CALL_FALLBACK:
+    pWord->code(pVM);
+}
+
+/**************************************************************************
+                        v m S t e p
+** Execute a single instruction.
+**************************************************************************/
+void vmStep(FICL_VM *pVM)
+{
+    FICL_WORD *pWord;
+    CELL *dataTop = pVM->pStack->sp;
+    /* returnTop removed - return stack accessed directly via pVM->rStack->sp for reduced register pressure */
+#if FICL_WANT_FLOAT
+    FICL_FLOAT *floatTop = pVM->fStack->sp;
+#endif
+    IPTYPE ip = pVM->ip;
+
+    FICL_INT i;
+    FICL_UNS u;
+    CELL c, c2;
+    FICL_OPCODE opcode;
+
+    pWord = *ip++;
+    pVM->runningWord = pWord;
+
+    opcode = pWord->opcode;
+    if (opcode != FICL_OP_CALL)
+    {
+        VM_OP_SWITCH_INNER(OP_DONE);
+    }
+
+    pVM->pStack->sp = dataTop;
+    /* pVM->rStack->sp not synced - already accessed directly in operations */
+#if FICL_WANT_FLOAT
+    pVM->fStack->sp = floatTop;
 #endif
     pVM->ip = ip;
 
@@ -1482,29 +2145,202 @@ void vmReset(FICL_VM *pVM)
 /**************************************************************************
                         v m S e t T e x t O u t
 ** Binds the specified output callback to the vm. If you pass NULL,
-** binds the default output function (ficlTextOut)
+** binds the default output function (ficlTextOut). Output still
+** buffered for the old callback goes to it first. This also unbinds
+** any length-delimited callback, so all output goes to textOut.
 **************************************************************************/
 void vmSetTextOut(FICL_VM *pVM, OUTFUNC textOut)
 {
+    vmFlushOutput(pVM);
+
     if (textOut)
         pVM->textOut = textOut;
     else
         pVM->textOut = ficlTextOut;
 
+    pVM->textOutN = NULL;
+    return;
+}
+
+
+/**************************************************************************
+                        v m S e t T e x t O u t N
+** Binds a length-delimited output callback to the vm. It takes
+** precedence over textOut; pass NULL to go back to textOut.
+**************************************************************************/
+void vmSetTextOutN(FICL_VM *pVM, OUTFUNCN textOutN)
+{
+    vmFlushOutput(pVM);
+    pVM->textOutN = textOutN;
+    return;
+}
+
+
+/**************************************************************************
+                        v m S e t R e f i l l
+** Binds a source text callback (and its context, pVM->pRefillCtx) to
+** the vm for ficlExecRefill. Pass NULL to unbind it.
+**************************************************************************/
+void vmSetRefill(FICL_VM *pVM, REFILLFUNC refill, void *pCtx)
+{
+    pVM->refill = refill;
+    pVM->pRefillCtx = pCtx;
+    return;
+}
+
+
+/**************************************************************************
+                        v m S e t O u t p u t S i z e
+** Sets the size of the VM's output buffer in bytes (0 for unbuffered
+** output). Pending output is flushed first. Returns false (and leaves
+** the VM unbuffered) if the buffer can't be allocated.
+**************************************************************************/
+bool vmSetOutputSize(FICL_VM *pVM, size_t size)
+{
+    vmFlushOutput(pVM);
+
+    if (pVM->outBuf && !vmInArena(pVM, pVM->outBuf))
+        ficlFree(pVM->outBuf);
+    pVM->outBuf  = NULL;
+    pVM->outSize = 0;
+
+    if (size > 0)
+    {
+        pVM->outBuf = (char *)ficlMalloc(size);
+        if (pVM->outBuf == NULL)
+            return false;
+        pVM->outSize = size;
+    }
+
+    return true;
+}
+
+
+/*
+** Hands len bytes of text straight to the VM's output callback.
+** textOutN takes them as they are; a legacy textOut needs a null
+** terminated string, so the text goes to it via a stack buffer,
+** nPAD-1 bytes at a time.
+*/
+static void vmSendOut(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
+{
+    char chunk[nPAD];
+
+    if (pVM->textOutN)
+    {
+        (pVM->textOutN)(pVM, text, len, fNewline);
+        return;
+    }
+
+    while (len >= sizeof (chunk))
+    {
+        memcpy(chunk, text, sizeof (chunk) - 1);
+        chunk[sizeof (chunk) - 1] = '\0';
+        (pVM->textOut)(pVM, chunk, false);
+        text += sizeof (chunk) - 1;
+        len  -= sizeof (chunk) - 1;
+    }
+
+    memcpy(chunk, text, len);
+    chunk[len] = '\0';
+    (pVM->textOut)(pVM, chunk, fNewline);
+    return;
+}
+
+
+/*
+** Empties the output buffer into the callback. outLen is always less
+** than outSize, so there's room to null terminate for a legacy textOut.
+*/
+static void vmDrainOutput(FICL_VM *pVM, bool fNewline)
+{
+    size_t len = pVM->outLen;
+
+    pVM->outLen = 0;
+    if (pVM->textOutN)
+    {
+        (pVM->textOutN)(pVM, pVM->outBuf, len, fNewline);
+    }
+    else
+    {
+        pVM->outBuf[len] = '\0';
+        (pVM->textOut)(pVM, pVM->outBuf, fNewline);
+    }
+
+    return;
+}
+
+
+/**************************************************************************
+                        v m F l u s h O u t p u t
+** Hands any buffered output to the VM's output callback
+**************************************************************************/
+void vmFlushOutput(FICL_VM *pVM)
+{
+    if (pVM->outLen > 0)
+        vmDrainOutput(pVM, false);
+
+    return;
+}
+
+
+/**************************************************************************
+                        v m T e x t O u t N
+** Feeds len bytes of text (need not be null terminated) to the vm's
+** output callback. If the VM has an output buffer, text collects there
+** and goes to the callback in one piece at the next newline, when the
+** buffer fills, on vmFlushOutput (flush-output), or when ficlExec
+** returns. Text too big for the buffer goes to the callback directly.
+**************************************************************************/
+void vmTextOutN(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
+{
+    assert(pVM);
+    assert(pVM->textOut);
+
+    if (pVM->outSize == 0)
+    {
+        vmSendOut(pVM, text, len, fNewline);
+        return;
+    }
+
+    if (pVM->outLen + len >= pVM->outSize)
+    {
+        vmFlushOutput(pVM);
+        if (len >= pVM->outSize)
+        {
+            vmSendOut(pVM, text, len, fNewline);
+            return;
+        }
+    }
+
+    memcpy(pVM->outBuf + pVM->outLen, text, len);
+    pVM->outLen += len;
+
+    if (fNewline)
+        vmDrainOutput(pVM, true);
+
     return;
 }
 
 
 /**************************************************************************
                         v m T e x t O u t
-** Feeds text to the vm's output callback
+** Feeds a null terminated string to the vm's output callback - see
+** vmTextOutN.
 **************************************************************************/
 void vmTextOut(FICL_VM *pVM, const char *text, bool fNewline)
 {
     assert(pVM);
     assert(pVM->textOut);
-    (pVM->textOut)(pVM, text, fNewline);
 
+    /* unbuffered legacy callback: no need to measure the string */
+    if ((pVM->outSize == 0) && (pVM->textOutN == NULL))
+    {
+        (pVM->textOut)(pVM, text, fNewline);
+        return;
+    }
+
+    vmTextOutN(pVM, text, strlen(text), fNewline);
     return;
 }
 
@@ -1651,70 +2487,120 @@ int isPowerOfTwo(FICL_UNS u)
 
 
 /**************************************************************************
-                        l t o a   &   u l t o a
-**
+                        u l t o a E n d   &   l t o a E n d
+** Fast integer formatting. Digits are written right-to-left ending just
+** before end, and the return value points at the most significant
+** digit, so callers that build into the tail of a buffer get the text
+** and its length (end - result) with no reversal and no strlen.
+** Base 10 emits two digits per division via a "00".."99" pair table;
+** power-of-two bases (binary, octal, hex, base 32) use shift and mask
+** and never divide. Other bases fall back to one division per digit.
+** No terminating NUL is written. end must have room for
+** FICL_ULTOA_MAX bytes before it.
 **************************************************************************/
-static char *ltoaFactor( FICL_INT value, char *string, int radix )
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+char *ficlUltoaEnd(FICL_UNS value, char *end, int radix)
 {
-    char *cp = string;
-    int pwr = isPowerOfTwo((FICL_UNS)radix);
+    char *cp = end;
     assert(radix > 1);
     assert(radix < 37);
-    assert(string);
+    assert(end);
 
-    if (value == 0)
-        *cp++ = '0';
-    else if (pwr != 0)
+    if (radix == 10)
     {
-        FICL_UNS v = (FICL_UNS) value;
-        FICL_UNS mask = ~(~0u << pwr);
-        while (v)
+        while (value >= 100)
+        {
+            const char *pair = digitPairs + 2 * (value % 100);
+            value /= 100;
+            *--cp = pair[1];
+            *--cp = pair[0];
+        }
+
+        if (value >= 10)
         {
-            *cp++ = digits[v & mask];
-            v >>= pwr;
+            *--cp = digitPairs[2 * value + 1];
+            *--cp = digitPairs[2 * value];
         }
+        else
+            *--cp = (char)('0' + value);
+    }
+    else if ((radix & (radix - 1)) == 0)
+    {
+        int shift = 1;
+        FICL_UNS mask = (FICL_UNS)radix - 1;
+        while ((1 << shift) != radix)
+            shift++;
+
+        do
+        {
+            *--cp = digits[value & mask];
+            value >>= shift;
+        }
+        while (value);
     }
     else
     {
-        UNSQR result;
-        DPUNS v;
-        v.hi = 0;
-        v.lo = (FICL_UNS)value;
-        while (v.lo)
+        FICL_UNS u = (FICL_UNS)radix;
+        do
         {
-            result = ficlLongDiv(v, (FICL_UNS)radix);
-            *cp++ = digits[result.rem];
-            v.lo = result.quot;
+            *--cp = digits[value % u];
+            value /= u;
         }
+        while (value);
     }
 
-    *cp = '\0';
     return cp;
 }
 
 
-char *ficlLtoa( FICL_INT value, char *string, int radix )
-{                               /* convert long to string, any base */
-    int isNeg = (value < 0);
-    if (isNeg)
-        value = -value;
+char *ficlLtoaEnd(FICL_INT value, char *end, int radix)
+{
+    char *cp;
 
-    char *cp = ltoaFactor( value, string, radix );
+    if (value < 0)
+    {   /* negate as unsigned so the most negative cell survives */
+        cp = ficlUltoaEnd((FICL_UNS)0 - (FICL_UNS)value, end, radix);
+        *--cp = '-';
+    }
+    else
+        cp = ficlUltoaEnd((FICL_UNS)value, end, radix);
+
+    return cp;
+}
 
-    if (isNeg)
-        *cp++ = '-';
 
-    *cp++ = '\0';
+/**************************************************************************
+                        l t o a   &   u l t o a
+** NUL-terminated wrappers around the right-to-left formatters above
+**************************************************************************/
+char *ficlLtoa( FICL_INT value, char *string, int radix )
+{                               /* convert long to string, any base */
+    char buf[FICL_ULTOA_MAX + 1];
+    char *end = buf + sizeof(buf);
+    char *cp = ficlLtoaEnd(value, end, radix);
+    size_t len = end - cp;
 
-    return ficlStrrev(string);
+    memcpy(string, cp, len);
+    string[len] = '\0';
+    return string;
 }
 
 
 char *ficlUltoa(FICL_UNS value, char *string, int radix )
 {                               /* convert long to string, any base */
-    char *cp = ltoaFactor( value, string, radix );
-    *cp++ = '\0';
-    return ficlStrrev(string);
+    char buf[FICL_ULTOA_MAX];
+    char *end = buf + sizeof(buf);
+    char *cp = ficlUltoaEnd(value, end, radix);
+    size_t len = end - cp;
+
+    memcpy(string, cp, len);
+    string[len] = '\0';
+    return string;
 }
 
 
@@ -1753,3 +2639,502 @@ const char *skipSpace(const char *cp, const char *end)
 
     return cp;
 }
+
+
+/**************************************************************************
+                        m e m o r y   k e r n e l s
+** Bulk byte operations behind MOVE, CMOVE, CMOVE>, FILL, ERASE, COMPARE,
+** SEARCH, SCAN and SKIP. Straight copies, fills, compares and single-byte
+** searches are left to memmove/memset/memcmp/memchr, which the C library
+** already vectorises (and dispatches by CPU) on the hosts that matter.
+** The two operations libc has no equivalent for - case-folding compare
+** and "find the first byte that differs from c" - get an SSE2 path when
+** FICL_HAVE_SSE2 is set and a plain byte loop otherwise.
+**************************************************************************/
+#if FICL_HAVE_SSE2
+/* ASCII A-Z to a-z on 16 lanes; bytes >= 0x80 compare negative and stay put */
+static __m128i foldCase16(__m128i x)
+{
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('A' - 1)),
+                                  _mm_cmplt_epi8(x, _mm_set1_epi8('Z' + 1)));
+    return _mm_add_epi8(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif
+
+static unsigned char foldCase(unsigned char c)
+{
+    return ((c >= 'A') && (c <= 'Z')) ? (unsigned char)(c + 0x20) : c;
+}
+
+
+/*
+** CMOVE semantics: copy u bytes low address first. When dst overlaps
+** the tail of src the result repeats src's first (dst - src) bytes;
+** that pattern is laid down with memcpy in doubling runs.
+*/
+void ficlCmove(char *dst, const char *src, FICL_UNS u)
+{
+    FICL_UNS d, done, n;
+
+    if ((dst <= src) || (dst >= src + u))
+    {
+        memmove(dst, src, u);
+        return;
+    }
+
+    d = (FICL_UNS)(dst - src);
+    for (done = 0; done < u; done += n)
+    {
+        n = d + done;
+        if (n > u - done)
+            n = u - done;
+        memcpy(dst + done, src, n);
+    }
+    return;
+}
+
+
+/*
+** CMOVE> semantics: copy u bytes high address first - the mirror image
+** of ficlCmove, repeating the last (src - dst) bytes of src downward.
+*/
+void ficlCmoveUp(char *dst, const char *src, FICL_UNS u)
+{
+    FICL_UNS d, done, n;
+
+    if ((dst >= src) || (dst + u <= src))
+    {
+        memmove(dst, src, u);
+        return;
+    }
+
+    d = (FICL_UNS)(src - dst);
+    for (done = 0; done < u; done += n)
+    {
+        n = d + done;
+        if (n > u - done)
+            n = u - done;
+        memcpy(dst + u - done - n, src + u - n, n);
+    }
+    return;
+}
+
+
+/*
+** Three-way compare of two counted strings with COMPARE's result
+** convention (-1, 0, 1). Characters compare as unsigned values;
+** fCaseless folds ASCII letters first.
+*/
+int ficlMemCompare(const char *cp1, FICL_UNS u1, const char *cp2, FICL_UNS u2, bool fCaseless)
+{
+    FICL_UNS uMin = (u1 < u2) ? u1 : u2;
+    FICL_UNS i = 0;
+    int n = 0;
+
+    if (!fCaseless)
+    {
+        n = memcmp(cp1, cp2, uMin);
+    }
+    else
+    {
+#if FICL_HAVE_SSE2
+        for (; i + 16 <= uMin; i += 16)
+        {
+            __m128i a = foldCase16(_mm_loadu_si128((const __m128i *)(cp1 + i)));
+            __m128i b = foldCase16(_mm_loadu_si128((const __m128i *)(cp2 + i)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xffff)
+                break;          /* finish off this block byte-wise */
+        }
+#endif
+        for (; (i < uMin) && (n == 0); i++)
+            n = foldCase((unsigned char)cp1[i]) - foldCase((unsigned char)cp2[i]);
+    }
+
+    if (n == 0)
+        return (u1 < u2) ? -1 : (u1 > u2);
+
+    return (n < 0) ? -1 : 1;
+}
+
+
+/*
+** Returns the first occurrence of needle in hay, or NULL. An empty
+** needle matches at the start of hay. Candidates are found with memchr
+** on the needle's last character, then checked from the first; runs of
+** a repeated leading character (padding, indentation) then cost one
+** memchr instead of one per byte.
+*/
+const char *ficlMemSearch(const char *hay, FICL_UNS uHay, const char *needle, FICL_UNS uNeedle)
+{
+    const char *cp;
+    const char *end;
+    FICL_UNS tail;
+
+    if (uNeedle == 0)
+        return hay;
+    if (uNeedle > uHay)
+        return NULL;
+
+    tail = uNeedle - 1;
+    cp  = hay + tail;
+    end = hay + uHay;
+    while (cp < end)
+    {
+        cp = memchr(cp, needle[tail], (size_t)(end - cp));
+        if (cp == NULL)
+            return NULL;
+        if (memcmp(cp - tail, needle, tail) == 0)
+            return cp - tail;
+        cp++;
+    }
+
+    return NULL;
+}
+
+
+/*
+** Returns a pointer to the first byte of cp[0..u) that is not c,
+** or cp + u if there is none.
+*/
+const char *ficlMemSkip(const char *cp, FICL_UNS u, char c)
+{
+    const char *end = cp + u;
+
+#if FICL_HAVE_SSE2
+    __m128i match = _mm_set1_epi8(c);
+    while (end - cp >= 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)cp);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, match)) != 0xffff)
+            break;
+        cp += 16;
+    }
+#endif
+
+    while ((cp < end) && (*cp == c))
+        cp++;
+
+    return cp;
+}
+
+
+/**************************************************************************
+                        c e l l   a r r a y   k e r n e l s
+** Bulk operations on arrays of cells behind CELLS-SUM, CELLS-MIN,
+** CELLS-MAX, CELLS-PREFIX-SUM, CELLS-SORT, CELLS-BSEARCH and
+** CELLS-HISTOGRAM. Cells are signed and arithmetic wraps, as with +.
+** The sum has an SSE2 path; SSE2 has no 64 bit compare, so min/max stay
+** scalar, with loops the compiler turns into conditional moves.
+**************************************************************************/
+#define CELL_LANES (16 / sizeof (FICL_INT))
+
+FICL_INT ficlCellSum(const FICL_INT *p, FICL_UNS u)
+{
+    FICL_UNS sum = 0;
+    FICL_UNS i = 0;
+
+#if FICL_HAVE_SSE2
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    FICL_UNS lanes[CELL_LANES];
+    size_t j;
+
+    for (; i + 2 * CELL_LANES <= u; i += 2 * CELL_LANES)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(p + i + CELL_LANES));
+        if (sizeof (FICL_INT) == 8)
+        {
+            acc0 = _mm_add_epi64(acc0, x);
+            acc1 = _mm_add_epi64(acc1, y);
+        }
+        else
+        {
+            acc0 = _mm_add_epi32(acc0, x);
+            acc1 = _mm_add_epi32(acc1, y);
+        }
+    }
+    _mm_storeu_si128((__m128i *)lanes, (sizeof (FICL_INT) == 8)
+                     ? _mm_add_epi64(acc0, acc1) : _mm_add_epi32(acc0, acc1));
+    for (j = 0; j < CELL_LANES; j++)
+        sum += lanes[j];
+#endif
+
+    for (; i < u; i++)
+        sum += (FICL_UNS)p[i];
+
+    return (FICL_INT)sum;
+}
+
+
+/*
+** Index of the first smallest (or largest, if fMax) of p[0..u), u > 0.
+** Four independent running extremes keep the compare chains short; a
+** second pass finds where the winner first occurs.
+*/
+FICL_UNS ficlCellMinMax(const FICL_INT *p, FICL_UNS u, bool fMax)
+{
+    FICL_INT b0 = p[0], b1 = p[0], b2 = p[0], b3 = p[0];
+    FICL_UNS i = 0;
+
+#define CELL_BETTER(x, b) (fMax ? ((x) > (b)) : ((x) < (b)))
+    for (; i + 4 <= u; i += 4)
+    {
+        b0 = CELL_BETTER(p[i],     b0) ? p[i]     : b0;
+        b1 = CELL_BETTER(p[i + 1], b1) ? p[i + 1] : b1;
+        b2 = CELL_BETTER(p[i + 2], b2) ? p[i + 2] : b2;
+        b3 = CELL_BETTER(p[i + 3], b3) ? p[i + 3] : b3;
+    }
+    for (; i < u; i++)
+        b0 = CELL_BETTER(p[i], b0) ? p[i] : b0;
+    b0 = CELL_BETTER(b1, b0) ? b1 : b0;
+    b0 = CELL_BETTER(b2, b0) ? b2 : b0;
+    b0 = CELL_BETTER(b3, b0) ? b3 : b0;
+#undef CELL_BETTER
+
+    for (i = 0; p[i] != b0; i++)
+        ;
+    return i;
+}
+
+
+/*
+** In place inclusive running sum: p[i] becomes p[0] + ... + p[i].
+*/
+void ficlCellPrefixSum(FICL_INT *p, FICL_UNS u)
+{
+    FICL_UNS sum = 0;
+    FICL_UNS i;
+
+    for (i = 0; i < u; i++)
+    {
+        sum += (FICL_UNS)p[i];
+        p[i] = (FICL_INT)sum;
+    }
+}
+
+
+/*
+** Index of the first element of sorted p[0..u) that is not less than n
+** (u if there is none). The halving loop has no data-dependent branch.
+*/
+FICL_UNS ficlCellLowerBound(const FICL_INT *p, FICL_UNS u, FICL_INT n)
+{
+    const FICL_INT *base = p;
+
+    if (u == 0)
+        return 0;
+
+    while (u > 1)
+    {
+        FICL_UNS half = u / 2;
+        base = (base[half] < n) ? base + half : base;
+        u -= half;
+    }
+
+    return (FICL_UNS)(base - p) + (*base < n);
+}
+
+
+/*
+** Add one to counts[x] for each x of p[0..u) in [0, nBins). Returns the
+** number of elements outside that range.
+*/
+FICL_UNS ficlCellHistogram(const FICL_INT *p, FICL_UNS u, FICL_UNS *counts, FICL_UNS nBins)
+{
+    FICL_UNS outside = 0;
+    FICL_UNS i;
+
+    for (i = 0; i < u; i++)
+    {
+        FICL_UNS x = (FICL_UNS)p[i];
+        if (x < nBins)
+            counts[x]++;
+        else
+            outside++;
+    }
+
+    return outside;
+}
+
+
+/*
+** Ascending sort. Arrays of CELL_RADIX_MIN cells or more use an LSD
+** radix sort, one byte per pass, skipping any byte that is the same in
+** every cell - so small keys in a wide cell cost only a few passes. It
+** needs a scratch copy; if that can't be had, or the array is short,
+** an in place introsort (quicksort falling back to heapsort) does it.
+*/
+#define CELL_RADIX_MIN   256
+#define CELL_INSERT_MAX  16
+
+static void cellInsertionSort(FICL_INT *p, FICL_UNS u)
+{
+    FICL_UNS i, j;
+
+    for (i = 1; i < u; i++)
+    {
+        FICL_INT x = p[i];
+        for (j = i; (j > 0) && (p[j - 1] > x); j--)
+            p[j] = p[j - 1];
+        p[j] = x;
+    }
+}
+
+static void cellSiftDown(FICL_INT *p, FICL_UNS root, FICL_UNS u)
+{
+    FICL_INT x = p[root];
+    FICL_UNS child;
+
+    while ((child = 2 * root + 1) < u)
+    {
+        if ((child + 1 < u) && (p[child + 1] > p[child]))
+            child++;
+        if (p[child] <= x)
+            break;
+        p[root] = p[child];
+        root = child;
+    }
+    p[root] = x;
+}
+
+static void cellHeapSort(FICL_INT *p, FICL_UNS u)
+{
+    FICL_UNS i;
+
+    for (i = u / 2; i-- > 0; )
+        cellSiftDown(p, i, u);
+    for (i = u; i-- > 1; )
+    {
+        FICL_INT x = p[0];
+        p[0] = p[i];
+        p[i] = x;
+        cellSiftDown(p, 0, i);
+    }
+}
+
+static void cellIntroSort(FICL_INT *p, FICL_UNS u, int depth)
+{
+    while (u > CELL_INSERT_MAX)
+    {
+        FICL_INT pivot, a, b, c;
+        FICL_UNS i, j;
+
+        if (depth-- == 0)
+        {
+            cellHeapSort(p, u);
+            return;
+        }
+
+        a = p[0]; b = p[u / 2]; c = p[u - 1];
+        pivot = (a < b) ? ((b < c) ? b : (a < c) ? c : a)
+                        : ((a < c) ? a : (b < c) ? c : b);
+
+        /* Hoare partition: p[0..j] <= pivot <= p[j+1..u) */
+        i = 0;
+        j = u - 1;
+        for (;;)
+        {
+            FICL_INT x;
+            while (p[i] < pivot)
+                i++;
+            while (p[j] > pivot)
+                j--;
+            if (i >= j)
+                break;
+            x = p[i]; p[i] = p[j]; p[j] = x;
+            i++;
+            j--;
+        }
+
+        /* recurse into the smaller side, loop on the larger */
+        if (j + 1 < u - j - 1)
+        {
+            cellIntroSort(p, j + 1, depth);
+            p += j + 1;
+            u -= j + 1;
+        }
+        else
+        {
+            cellIntroSort(p + j + 1, u - j - 1, depth);
+            u = j + 1;
+        }
+    }
+
+    cellInsertionSort(p, u);
+}
+
+static bool cellRadixSort(FICL_INT *p, FICL_UNS u)
+{
+    FICL_UNS (*counts)[256];
+    FICL_UNS *src = (FICL_UNS *)p;
+    FICL_UNS *dst;
+    FICL_UNS i;
+    FICL_UNS signBit = (FICL_UNS)1 << (8 * sizeof (FICL_UNS) - 1);
+    unsigned pass;
+
+    /* one row of 256 counts for each byte of a cell */
+    counts = ficlMalloc(sizeof (FICL_UNS) * sizeof (counts[0]));
+    if (counts == NULL)
+        return false;
+    dst = (FICL_UNS *)ficlMalloc(u * sizeof (FICL_UNS));
+    if (dst == NULL)
+    {
+        ficlFree(counts);
+        return false;
+    }
+    memset(counts, 0, sizeof (FICL_UNS) * sizeof (counts[0]));
+
+    /* flipping the sign bit makes signed order unsigned order */
+    for (i = 0; i < u; i++)
+    {
+        FICL_UNS x = src[i] ^ signBit;
+        for (pass = 0; pass < sizeof (FICL_UNS); pass++)
+            counts[pass][(x >> (8 * pass)) & 0xff]++;
+    }
+
+    for (pass = 0; pass < sizeof (FICL_UNS); pass++)
+    {
+        FICL_UNS *count = counts[pass];
+        FICL_UNS *tmp;
+        FICL_UNS sum = 0;
+        unsigned shift = 8 * pass;
+        int d;
+
+        if (count[((src[0] ^ signBit) >> shift) & 0xff] == u)
+            continue;           /* every cell has the same byte here */
+
+        for (d = 0; d < 256; d++)
+        {
+            FICL_UNS n = count[d];
+            count[d] = sum;
+            sum += n;
+        }
+        for (i = 0; i < u; i++)
+            dst[count[((src[i] ^ signBit) >> shift) & 0xff]++] = src[i];
+
+        tmp = src; src = dst; dst = tmp;
+    }
+
+    if (src != (FICL_UNS *)p)
+    {
+        memcpy(p, src, u * sizeof (FICL_UNS));
+        dst = src;
+    }
+    ficlFree(dst);
+    ficlFree(counts);
+    return true;
+}
+
+void ficlCellSort(FICL_INT *p, FICL_UNS u)
+{
+    int depth = 0;
+    FICL_UNS n;
+
+    if ((u >= CELL_RADIX_MIN) && cellRadixSort(p, u))
+        return;
+
+    for (n = u; n > 1; n >>= 1)
+        depth += 2;
+    cellIntroSort(p, u, depth);
+}
@@ -85,6 +85,24 @@ void ficlTextOut(FICL_VM *pVM, const char *msg, bool fNewline)
     return;
 }
 
+void ficlTextOutN(FICL_VM *pVM, const char *text, size_t len, bool fNewline)
+{
+    size_t room = WASM_OUTBUF_SIZE - 1 - nOutbuf;
+
+    FICL_IGNORE(pVM);
+
+    if (len > room)
+        len = room;
+    memcpy(outbuf + nOutbuf, text, len);
+    nOutbuf += len;
+    if (fNewline && nOutbuf < WASM_OUTBUF_SIZE - 1)
+    {
+        outbuf[nOutbuf++] = '\n';
+    }
+    outbuf[nOutbuf] = '\0';
+    return;
+}
+
 void ficlWasmClearOutput(void)
 {
     nOutbuf = 0;
@@ -388,13 +388,14 @@ static void displayCell(FICL_VM *pVM)
 {
     CELL c;
     char outbuf[nPAD];
+    char *cp;
 #if FICL_ROBUST > 1
     vmCheckStack(pVM, 1, 0);
 #endif
     c = stackPop(pVM->pStack);
-    ficlLtoa((c).i, outbuf, pVM->base);
-    strcat(outbuf, " ");
-    vmTextOut(pVM, outbuf, false);
+    cp = ficlLtoaEnd(c.i, outbuf + nPAD - 1, pVM->base);
+    outbuf[nPAD - 1] = ' ';
+    vmTextOutN(pVM, cp, outbuf + nPAD - cp, false);
     return;
 }
 
@@ -402,13 +403,14 @@ static void uDot(FICL_VM *pVM)
 {
     FICL_UNS u;
     char outbuf[nPAD];
+    char *cp;
 #if FICL_ROBUST > 1
     vmCheckStack(pVM, 1, 0);
 #endif
     u = stackPopUNS(pVM->pStack);
-    ficlUltoa(u, outbuf, pVM->base);
-    strcat(outbuf, " ");
-    vmTextOut(pVM, outbuf, false);
+    cp = ficlUltoaEnd(u, outbuf + nPAD - 1, pVM->base);
+    outbuf[nPAD - 1] = ' ';
+    vmTextOutN(pVM, cp, outbuf + nPAD - cp, false);
     return;
 }
 
@@ -416,13 +418,14 @@ static void hexDot(FICL_VM *pVM)
 {
     FICL_UNS u;
     char outbuf[nPAD];
+    char *cp;
 #if FICL_ROBUST > 1
     vmCheckStack(pVM, 1, 0);
 #endif
     u = stackPopUNS(pVM->pStack);
-    ficlUltoa(u, outbuf, 16);
-    strcat(outbuf, " ");
-    vmTextOut(pVM, outbuf, false);
+    cp = ficlUltoaEnd(u, outbuf + nPAD - 1, 16);
+    outbuf[nPAD - 1] = ' ';
+    vmTextOutN(pVM, cp, outbuf + nPAD - cp, false);
     return;
 }
 
@@ -637,16 +640,13 @@ static void twoSwap(FICL_VM *pVM)
 
 static void emit(FICL_VM *pVM)
 {
-    char cp[2];
-    int i;
+    char ch;
 
 #if FICL_ROBUST > 1
     vmCheckStack(pVM, 1, 0);
 #endif
-    i = stackPopINT(pVM->pStack);
-    cp[0] = (char)i;
-    cp[1] = '\0';
-    vmTextOut(pVM, cp, false);
+    ch = (char)stackPopINT(pVM->pStack);
+    vmTextOutN(pVM, &ch, 1, false);
     return;
 }
 
@@ -658,6 +658,17 @@ static void cr(FICL_VM *pVM)
 }
 
 
+/*
+** flush-output    ficl ( -- )
+** Send any buffered output to the VM's output callback now
+*/
+static void flushOutput(FICL_VM *pVM)
+{
+    vmFlushOutput(pVM);
+    return;
+}
+
+
 static void commentLine(FICL_VM *pVM)
 {
     const char *cp   = vmGetInBuf(pVM);
@@ -1116,7 +1127,33 @@ static void interpret(FICL_VM *pVM)
 ** d) If unsuccessful, an ambiguous condition exists (see 3.4.4).
 **
 ** (jws 4/01) Modified to be a FICL_PARSE_STEP
+**
+** When compiling, I + / I CELLS / I CELLS + are fused into a single
+** superinstruction by rewriting the previous cell in place. That is only
+** safe if the previous cell is the word this step compiled last and
+** nothing has touched the dictionary since: pSys->pFuseMark records here
+** after each compile. Literals move here past the mark, and every
+** immediate word (THEN, BEGIN, [, ...) clears it, so a branch target can
+** never land between the two halves of a fused pair.
 **************************************************************************/
+static FICL_WORD *fuseWords(FICL_SYSTEM *pSys, FICL_WORD *pPrev, FICL_WORD *pNext)
+{
+    if (pPrev->opcode == FICL_OP_LOOP_I)
+    {
+        if (pNext->opcode == FICL_OP_PLUS)
+            return pSys->pIPlus;
+        if (pNext == pSys->pCells)
+            return pSys->pICells;
+    }
+    else if (pPrev->opcode == FICL_OP_I_CELLS)
+    {
+        if (pNext->opcode == FICL_OP_PLUS)
+            return pSys->pICellsPlus;
+    }
+
+    return NULL;
+}
+
 static bool ficlParseWord(FICL_VM *pVM, STRINGINFO si)
 {
     FICL_DICT *dp = vmGetDict(pVM);
@@ -1140,6 +1177,7 @@ static bool ficlParseWord(FICL_VM *pVM, STRINGINFO si)
     {
         if (tempFW != NULL)
         {
+            pVM->pSys->pFuseMark = NULL;
             if (wordIsCompileOnly(tempFW))
             {
                 vmTextOut(pVM, "Error: >> ", false);
@@ -1158,11 +1196,22 @@ static bool ficlParseWord(FICL_VM *pVM, STRINGINFO si)
         {
             if (wordIsImmediate(tempFW))
             {
+                pVM->pSys->pFuseMark = NULL;
                 vmExecute(pVM, tempFW);
             }
             else
             {
-                dictAppendCell(dp, LVALUEtoCELL(tempFW));
+                FICL_WORD *pFused = NULL;
+
+                if (pVM->pSys->pFuseMark == dp->here)
+                    pFused = fuseWords(pVM->pSys, (FICL_WORD *)dp->here[-1].p, tempFW);
+
+                if (pFused)
+                    dp->here[-1] = LVALUEtoCELL(pFused);
+                else
+                    dictAppendCell(dp, LVALUEtoCELL(tempFW));
+
+                pVM->pSys->pFuseMark = dp->here;
             }
             return true;
         }
@@ -1367,34 +1416,6 @@ static void plusLoopCoIm(FICL_VM *pVM)
 }
 
 
-static void loopICo(FICL_VM *pVM)
-{
-    CELL index = stackGetTop(pVM->rStack);
-    stackPush(pVM->pStack, index);
-
-    return;
-}
-
-
-static void loopJCo(FICL_VM *pVM)
-{
-    CELL index = stackFetch(pVM->rStack, 3);
-    stackPush(pVM->pStack, index);
-
-    return;
-}
-
-
-static void loopKCo(FICL_VM *pVM)
-{
-    CELL index = stackFetch(pVM->rStack, 6);
-    stackPush(pVM->pStack, index);
-
-    return;
-}
-
-
-
 /**************************************************************************
                         v a r i a b l e
 **
@@ -1682,6 +1703,529 @@ static void isObject(FICL_VM *pVM)
     return;
 }
 
+
+#if FICL_WANT_OOP
+/**************************************************************************
+                        m e t h o d   c a c h e s
+** Late binding support for oo.fr. A class is the body of a CREATE word:
+** cell 0 is the parent class, cell 1 the method wordlist. Looking a method
+** up by name walks that wordlist and its parents; ficlLookupMethod puts a
+** small cache in front of the walk (two classes per site, layout in ficl.h).
+** Any wordlist change bumps ficlHashEpoch, which empties every cache the
+** next time it is consulted.
+**************************************************************************/
+FICL_WORD *ficlLookupMethod(FICL_VM *pVM, CELL *pCache, void *pClass, STRINGINFO si)
+{
+    FICL_WORD *pFW;
+
+    if (pCache[0].u == ficlHashEpoch)
+    {
+        if (pCache[1].p == pClass)
+            return (FICL_WORD *)pCache[2].p;
+        if (pCache[3].p == pClass)
+            return (FICL_WORD *)pCache[4].p;
+    }
+    else
+    {
+        pCache[0].u = ficlHashEpoch;
+        pCache[1].p = NULL;
+        pCache[3].p = NULL;
+    }
+
+    ficlLockDictionary(true);
+    pFW = hashLookup((FICL_HASH *)((CELL *)pClass)[FICL_CLASS_WID].p, si, hashHashCode(si));
+    ficlLockDictionary(false);
+
+    if (pFW == NULL)
+    {
+        FICL_WORD *pClassFW = (FICL_WORD *)((char *)pClass - FICL_WORD_BASE_BYTES);
+        snprintf(pVM->scratch, sizeof(pVM->scratch), "%.*s not found in %.*s",
+            (int)SI_COUNT(si), SI_PTR(si), (int)pClassFW->nName, pClassFW->name);
+        vmTextOut(pVM, pVM->scratch, true);
+        vmThrow(pVM, VM_ABORT);
+    }
+
+    pCache[3] = pCache[1];
+    pCache[4] = pCache[2];
+    pCache[1].p = pClass;
+    pCache[2].p = pFW;
+    return pFW;
+}
+
+
+/*
+** method-cache,  ( -- )
+** Append an empty method cache to the dictionary.
+*/
+static void methodCacheComma(FICL_VM *pVM)
+{
+    FICL_DICT *dp = vmGetDict(pVM);
+    int i;
+
+    for (i = 0; i < FICL_METHOD_CACHE_CELLS; i++)
+        dictAppendUNS(dp, 0);
+
+    return;
+}
+
+
+/*
+** method-call,  ( xt "name" -- )
+** Compile a late-bound call to method "name": xt is (-->) or (c->),
+** followed by an empty cache and the name. This replaces the
+** parse-method / exec-method pair that --> used to compile.
+*/
+static void compileMethodCall(FICL_VM *pVM, FICL_WORD *pFW, STRINGINFO si)
+{
+    FICL_DICT *dp = vmGetDict(pVM);
+    char *cpDest;
+
+    dictAppendCell(dp, LVALUEtoCELL(pFW));
+    methodCacheComma(pVM);
+
+    cpDest    = (char *)dp->here;
+    *cpDest++ = (char)SI_COUNT(si);
+    memcpy(cpDest, SI_PTR(si), SI_COUNT(si));
+    cpDest   += SI_COUNT(si);
+    *cpDest++ = 0;
+    dp->here  = PTRtoCELL alignPtr(cpDest);
+    return;
+}
+
+static void methodCallComma(FICL_VM *pVM)
+{
+    FICL_WORD *pFW;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 1, 0);
+#endif
+
+    pFW = (FICL_WORD *)POPPTR();
+    compileMethodCall(pVM, pFW, vmGetWord(pVM));
+    return;
+}
+
+
+/*
+** (method)  ( instance class pfa -- ??? )
+** Runtime of words made by METHOD: the word's body holds its cache and
+** the method name is the word's own name.
+*/
+static void methodParen(FICL_VM *pVM)
+{
+    CELL *pCache;
+    FICL_WORD *pFW;
+    STRINGINFO si;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 3, 2);
+#endif
+
+    pCache = (CELL *)POPPTR();
+    pFW    = (FICL_WORD *)((char *)pCache - FICL_WORD_BASE_BYTES);
+    SI_SETPTR(si, pFW->name);
+    SI_SETLEN(si, pFW->nName);
+
+    pFW = ficlLookupMethod(pVM, pCache, stackGetTop(pVM->pStack).p, si);
+    vmExecute(pVM, pFW);
+    return;
+}
+
+
+/**************************************************************************
+                        o b j e c t   p r i m i t i v e s
+** Native versions of the hot parts of oo.fr. The member words keep the
+** body layout of the CREATE ... DOES> words they replace (offset, then
+** member class), so OFFSET-OF, my=[ and ?object work on them unchanged.
+**************************************************************************/
+static void setMemberOpcode(FICL_VM *pVM, FICL_OPCODE opcode)
+{
+    FICL_WORD *pFW = vmGetDict(pVM)->smudge;
+
+    assert(pFW);
+    pFW->code = NULL;
+    pFW->opcode = opcode;
+    return;
+}
+
+/*
+** (instance-var)  ( -- )
+** Make the last CREATEd word an instance variable:
+** run-time ( instance class -- addr )
+*/
+static void instanceVarParen(FICL_VM *pVM)
+{
+    setMemberOpcode(pVM, FICL_OP_IVAR);
+    return;
+}
+
+/*
+** (aggregate)  ( -- )
+** Make the last CREATEd word an aggregated object member:
+** run-time ( instance class -- a-instance a-class )
+*/
+static void aggregateParen(FICL_VM *pVM)
+{
+    setMemberOpcode(pVM, FICL_OP_AGGREGATE);
+    return;
+}
+
+/*
+** (ref)  ( -- )
+** Make the last CREATEd word an object reference member:
+** run-time ( instance class -- r-instance r-class )
+*/
+static void refParen(FICL_VM *pVM)
+{
+    setMemberOpcode(pVM, FICL_OP_REF);
+    return;
+}
+
+#define CLASS_SIZE(pClass) (((CELL *)(pClass))[FICL_CLASS_SIZE].u)
+
+/*
+** (index)  ( n instance class -- instance[n] class )
+*/
+static void indexParen(FICL_VM *pVM)
+{
+    CELL *pClass;
+    char *pInst;
+    FICL_INT n;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 3, 2);
+#endif
+
+    pClass = (CELL *)POPPTR();
+    pInst  = (char *)POPPTR();
+    n      = POPINT();
+    PUSHPTR(pInst + n * (FICL_INT)CLASS_SIZE(pClass));
+    PUSHPTR(pClass);
+    return;
+}
+
+/*
+** (next)  ( instance[n] class -- instance[n+1] class )
+** (prev)  ( instance[n] class -- instance[n-1] class )
+*/
+static void nextParen(FICL_VM *pVM)
+{
+    CELL *pInst;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 2, 2);
+#endif
+
+    pInst = pVM->pStack->sp - 2;
+    pInst->p = (char *)pInst->p + CLASS_SIZE(pInst[1].p);
+    return;
+}
+
+static void prevParen(FICL_VM *pVM)
+{
+    CELL *pInst;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 2, 2);
+#endif
+
+    pInst = pVM->pStack->sp - 2;
+    pInst->p = (char *)pInst->p - CLASS_SIZE(pInst[1].p);
+    return;
+}
+
+/*
+** (init)  ( instance class -- )
+** Default INIT: zero fill the instance's payload.
+*/
+static void initParen(FICL_VM *pVM)
+{
+    CELL *pClass;
+    void *pInst;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 2, 0);
+#endif
+
+    pClass = (CELL *)POPPTR();
+    pInst  = POPPTR();
+    memset(pInst, 0, CLASS_SIZE(pClass));
+    return;
+}
+
+/*
+** (alloc)  ( class metaclass -- instance class )
+** Heap storage for one instance. ALLOC still sends INIT late bound.
+*/
+static void allocParen(FICL_VM *pVM)
+{
+    CELL *pClass;
+    void *pInst;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 2, 2);
+#endif
+
+    DROP(1);
+    pClass = (CELL *)POPPTR();
+    pInst  = ficlAllocate(pVM, CLASS_SIZE(pClass));
+    if (pInst == NULL)
+        vmThrowErr(pVM, "Error: allocate failed");
+
+    PUSHPTR(pInst);
+    PUSHPTR(pClass);
+    return;
+}
+
+
+#if FICL_WANT_VCALL
+/**************************************************************************
+                        v t a b l e s
+** Each class gets a vtable (layout in ficl.h) when its definition first
+** ends. A method keeps the slot number it was first given in an ancestor,
+** so a call site compiled against a class also dispatches correctly on any
+** subclass of it.
+** Slots are only handed out then: a class reopened with RESUME-CLASS
+** keeps its table, and methods new to it get no slot (==> binds them
+** late). Ending it again bumps ficlVtableEpoch instead, which makes every
+** vtable refill its slots by name - the same lookup --> does - the next
+** time it is used, so overrides added on resume reach subclasses too.
+**************************************************************************/
+FICL_UNS ficlVtableEpoch = 1;
+
+static FICL_INT vtableSlot(CELL *pVtable, STRINGINFO si)
+{
+    FICL_UNS i;
+
+    if (pVtable == NULL)
+        return -1;
+
+    for (i = 0; i < pVtable[FICL_VTABLE_COUNT].u; i++)
+    {
+        FICL_WORD *pFW = (FICL_WORD *)pVtable[FICL_VTABLE_XT + i].p;
+        if ((pFW->nName == SI_COUNT(si))
+            && !strincmp(pFW->name, SI_PTR(si), SI_COUNT(si)))
+            return (FICL_INT)i;
+    }
+
+    return -1;
+}
+
+/*
+** Return class's vtable, refilled first if it predates ficlVtableEpoch.
+*/
+static CELL *classVtable(CELL *pClass)
+{
+    CELL *pVtable = (CELL *)pClass[FICL_CLASS_VTABLE].p;
+    FICL_HASH *pHash = (FICL_HASH *)pClass[FICL_CLASS_WID].p;
+    FICL_UNS i;
+
+    if (pVtable == NULL || pVtable[FICL_VTABLE_EPOCH].u == ficlVtableEpoch)
+        return pVtable;
+
+    ficlLockDictionary(true);
+    for (i = 0; i < pVtable[FICL_VTABLE_COUNT].u; i++)
+    {
+        FICL_WORD *pFW = (FICL_WORD *)pVtable[FICL_VTABLE_XT + i].p;
+        STRINGINFO si;
+
+        SI_SETPTR(si, pFW->name);
+        SI_SETLEN(si, pFW->nName);
+        pFW = hashLookup(pHash, si, hashHashCode(si));
+        if (pFW != NULL)
+            pVtable[FICL_VTABLE_XT + i].p = pFW;
+    }
+    ficlLockDictionary(false);
+
+    pVtable[FICL_VTABLE_EPOCH].u = ficlVtableEpoch;
+    return pVtable;
+}
+
+/*
+** Slow path of (vcall): the receiver's vtable is stale, its class has
+** no vtable, or the slot is past the end of the table. Ancestry is not
+** checked - a receiver whose class is not derived from the one the call
+** site was compiled against runs whatever method sits in that slot
+** (undefined behaviour, as for ==> in the docs).
+*/
+FICL_WORD *ficlVtableLookup(FICL_VM *pVM, void *pClass, FICL_UNS slot)
+{
+    CELL *pVtable = classVtable((CELL *)pClass);
+    FICL_WORD *pClassFW;
+
+    if (pVtable != NULL && slot < pVtable[FICL_VTABLE_COUNT].u)
+        return (FICL_WORD *)pVtable[FICL_VTABLE_XT + slot].p;
+
+    pClassFW = (FICL_WORD *)((char *)pClass - FICL_WORD_BASE_BYTES);
+    snprintf(pVM->scratch, sizeof(pVM->scratch), "no vtable slot " PCT_LD " in %.*s",
+        (FICL_INT)slot, (int)pClassFW->nName, pClassFW->name);
+    vmTextOut(pVM, pVM->scratch, true);
+    vmThrow(pVM, VM_ABORT);
+    return NULL;
+}
+
+/*
+** build-vtable  ( class -- )
+** Copy the parent's vtable, then walk the class's own wordlist in
+** definition order: a method whose name already has a slot overrides it,
+** anything else is appended. Only the newest definition of a name counts.
+** The table is laid down at HERE. A class that already has a vtable
+** (see RESUME-CLASS) just invalidates every table.
+*/
+static void buildVtable(FICL_VM *pVM)
+{
+    FICL_DICT *dp = vmGetDict(pVM);
+    CELL *pClass;
+    CELL *pParent;
+    CELL *pVtable;
+    FICL_HASH *pHash;
+    FICL_WORD *pLast = NULL;
+    FICL_UNS nSlots = 0;
+    FICL_UNS i;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 1, 0);
+#endif
+
+    pClass  = (CELL *)POPPTR();
+    pParent = (CELL *)pClass[FICL_CLASS_SUPER].p;
+    pHash   = (FICL_HASH *)pClass[FICL_CLASS_WID].p;
+
+    if (pClass[FICL_CLASS_VTABLE].p != NULL)
+    {
+        ficlVtableEpoch++;
+        return;
+    }
+
+    pVtable = dp->here;
+    dictAppendUNS(dp, 0);
+    dictAppendUNS(dp, ficlVtableEpoch);
+    if (pParent != NULL && pParent[FICL_CLASS_VTABLE].p != NULL)
+    {
+        CELL *pSuper = classVtable(pParent);
+        nSlots = pSuper[FICL_VTABLE_COUNT].u;
+        for (i = 0; i < nSlots; i++)
+            dictAppendCell(dp, pSuper[FICL_VTABLE_XT + i]);
+        pVtable[FICL_VTABLE_COUNT].u = nSlots;
+    }
+
+    /*
+    ** Words are laid down in increasing address order, so repeatedly
+    ** taking the lowest address above the last one visits them in
+    ** definition order. Classes have a few dozen methods at most.
+    */
+    for (;;)
+    {
+        FICL_WORD *pNext = NULL;
+        STRINGINFO si;
+        FICL_INT slot;
+
+        for (i = 0; i < pHash->size; i++)
+        {
+            FICL_WORD *pFW;
+            for (pFW = pHash->table[i]; pFW != NULL; pFW = pFW->link)
+            {
+                if (pFW > pLast && (pNext == NULL || pFW < pNext))
+                    pNext = pFW;
+            }
+        }
+
+        if (pNext == NULL)
+            break;
+        pLast = pNext;
+
+        SI_SETPTR(si, pNext->name);
+        SI_SETLEN(si, pNext->nName);
+        if (hashLookup(pHash, si, pNext->hash) != pNext)
+            continue;
+
+        slot = vtableSlot(pVtable, si);
+        if (slot >= 0)
+            pVtable[FICL_VTABLE_XT + slot].p = pNext;
+        else
+        {
+            dictAppendCell(dp, LVALUEtoCELL(pNext));
+            pVtable[FICL_VTABLE_COUNT].u = ++nSlots;
+        }
+    }
+
+    pClass[FICL_CLASS_VTABLE].p = pVtable;
+    return;
+}
+
+/*
+** vtable-slot  ( class c-addr u -- slot | -1 )
+*/
+static void vtableSlotWord(FICL_VM *pVM)
+{
+    STRINGINFO si;
+    CELL *pClass;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 3, 1);
+#endif
+
+    SI_SETLEN(si, POPUNS());
+    SI_SETPTR(si, (char *)POPPTR());
+    pClass = (CELL *)POPPTR();
+    PUSHINT(vtableSlot(classVtable(pClass), si));
+    return;
+}
+
+/*
+** vcall  ( instance class slot -- ??? )
+** Execute the method in the given slot of class's vtable.
+*/
+static void vcall(FICL_VM *pVM)
+{
+    FICL_UNS slot;
+    void *pClass;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 3, 2);
+#endif
+
+    slot    = POPUNS();
+    pClass  = stackGetTop(pVM->pStack).p;
+    vmExecute(pVM, ficlVtableLookup(pVM, pClass, slot));
+    return;
+}
+
+/*
+** vcall,  ( class "name" -- )
+** Compile a virtual call to method "name" of class: (vcall) and the
+** method's slot. If class has no slot by that name - typically because
+** its definition has not ended yet - compile a late-bound call instead.
+*/
+static void vcallComma(FICL_VM *pVM)
+{
+    FICL_DICT *dp = vmGetDict(pVM);
+    FICL_SYSTEM *pSys = pVM->pSys;
+    STRINGINFO si;
+    CELL *pClass;
+    FICL_INT slot;
+
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 1, 0);
+#endif
+
+    pClass = (CELL *)POPPTR();
+    si     = vmGetWord(pVM);
+    slot   = vtableSlot(classVtable(pClass), si);
+
+    if (slot < 0)
+    {
+        compileMethodCall(pVM, pSys->pMethodParen, si);
+        return;
+    }
+
+    dictAppendCell(dp, LVALUEtoCELL(pSys->pVcallParen));
+    dictAppendCell(dp, LVALUEtoCELL(slot));
+    return;
+}
+#endif
+#endif
+
 static void cstringQuoteIm(FICL_VM *pVM)
 {
     FICL_DICT *dp = vmGetDict(pVM);
@@ -1730,23 +2274,21 @@ static void dotQuoteCoIm(FICL_VM *pVM)
 
 static void dotParen(FICL_VM *pVM)
 {
-    const char *pSrc      = vmGetInBuf(pVM);
+    const char *pStart    = vmGetInBuf(pVM);
+    const char *pSrc      = pStart;
     const char *pEnd      = vmGetInBufEnd(pVM);
-    char outbuf[nPAD];
-    char *pDest     = outbuf;
     char ch;
 
     /*
     ** Note: the standard does not want leading spaces skipped (apparently)
     */
     for (ch = *pSrc; (pEnd != pSrc) && (ch != ')'); ch = *++pSrc)
-        *pDest++ = ch;
+        ;
 
-    *pDest = '\0';
+    vmTextOutN(pVM, pStart, (size_t)(pSrc - pStart), false);
     if ((pEnd != pSrc) && (ch == ')'))
         pSrc++;
 
-    vmTextOut(pVM, outbuf, false);
     vmUpdateTib(pVM, pSrc);
 
     return;
@@ -2022,12 +2564,28 @@ static void numberSignS(FICL_VM *pVM)
     sp = PTRtoSTRING pVM->scratch;
     u = dpmPopU(pVM->pStack);
 
-    do
+    /*
+    ** Peel digits off the high cell the slow way; once ud fits in a
+    ** single cell, format the rest in one shot and append it in the
+    ** reversed order the pictured buffer keeps until #>.
+    */
+    while (u.hi)
     {
         rem = dpmUMod(&u, (UNS16)(pVM->base));
         sp->text[sp->count++] = digit_to_char(rem);
     }
-    while (u.hi || u.lo);
+
+    {
+        char buf[FICL_ULTOA_MAX];
+        char *end = buf + sizeof(buf);
+        char *cp = ficlUltoaEnd(u.lo, end, pVM->base);
+        char *dest = sp->text + sp->count;
+
+        sp->count += end - cp;
+        while (end > cp)
+            *dest++ = *--end;
+        u.lo = 0;
+    }
 
     dpmPushU(pVM->pStack, u);
     return;
@@ -2485,22 +3043,7 @@ static void type(FICL_VM *pVM)
     count = POPUNS();
     cp = (const char *)POPPTR();
 
-    /*
-    ** Since we don't have an output primitive for a counted string
-    ** (oops), make sure the string is null terminated. If not, copy
-    ** and terminate it.
-    */
-    if (cp[count] != 0)
-    {
-        char *pDest = (char *)vmGetDict(pVM)->here;
-        if (cp != pDest)
-            strncpy(pDest, cp, count);
-
-        pDest[count] = '\0';
-        cp = pDest;
-    }
-
-    vmTextOut(pVM, cp, false);
+    vmTextOutN(pVM, cp, (size_t)count, false);
     return;
 }
 
@@ -2611,11 +3154,28 @@ static void fill(FICL_VM *pVM)
     u = POPUNS();
     cp = (char *)POPPTR();
 
-    while (u > 0)
-    {
-        *cp++ = ch;
-        u--;
-    }
+    memset(cp, (unsigned char)ch, u);
+    return;
+}
+
+
+/**************************************************************************
+                        e r a s e
+** CORE EXT ( addr u -- )
+** If u is greater than zero, clear all bits in each of u consecutive
+** address units of memory beginning at addr.
+**************************************************************************/
+static void erase(FICL_VM *pVM)
+{
+    FICL_UNS u;
+    char *cp;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM,2,0);
+#endif
+    u = POPUNS();
+    cp = (char *)POPPTR();
+
+    memset(cp, 0, u);
     return;
 }
 
@@ -2863,25 +3423,50 @@ static void move(FICL_VM *pVM)
     addr2 = (char *)POPPTR();
     addr1 = (char *)POPPTR();
 
-    if (u == 0)
-        return;
-    /*
-    ** Do the copy carefully, so as to be
-    ** correct even if the two ranges overlap
-    */
-    if (addr1 >= addr2)
-    {
-        for (; u > 0; u--)
-            *addr2++ = *addr1++;
-    }
-    else
-    {
-        addr2 += u-1;
-        addr1 += u-1;
-        for (; u > 0; u--)
-            *addr2-- = *addr1--;
-    }
+    memmove(addr2, addr1, u);
+    return;
+}
+
+
+/**************************************************************************
+                        c m o v e   &   c m o v e >
+** STRING ( c-addr1 c-addr2 u -- )
+** CMOVE copies u consecutive characters from c-addr1 to c-addr2 lowest
+** address first; CMOVE> copies highest address first. Unlike MOVE, an
+** overlapping copy propagates the characters already moved.
+**************************************************************************/
+static void cmove(FICL_VM *pVM)
+{
+    FICL_UNS u;
+    char *addr2;
+    char *addr1;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM,3,0);
+#endif
+
+    u = POPUNS();
+    addr2 = (char *)POPPTR();
+    addr1 = (char *)POPPTR();
+
+    ficlCmove(addr2, addr1, u);
+    return;
+}
+
+
+static void cmoveUp(FICL_VM *pVM)
+{
+    FICL_UNS u;
+    char *addr2;
+    char *addr1;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM,3,0);
+#endif
+
+    u = POPUNS();
+    addr2 = (char *)POPPTR();
+    addr1 = (char *)POPPTR();
 
+    ficlCmoveUp(addr2, addr1, u);
     return;
 }
 
@@ -3175,79 +3760,13 @@ static void toValue(FICL_VM *pVM)
 
 
 #if FICL_WANT_LOCALS
-/**************************************************************************
-                        l i n k P a r e n
-** ( -- )
-** Link a frame on the return stack, reserving nCells of space for
-** locals - the value of nCells is the next cell in the instruction
-** stream.
-**************************************************************************/
-static void linkParen(FICL_VM *pVM)
-{
-    FICL_INT nLink = *(FICL_INT *)(pVM->ip);
-    vmBranchRelative(pVM, 1);
-    stackLink(pVM->rStack, nLink);
-    return;
-}
-
-
-static void unlinkParen(FICL_VM *pVM)
-{
-    stackUnlink(pVM->rStack);
-    return;
-}
-
-
 /**************************************************************************
                         d o L o c a l I m
 ** Immediate - cfa of a local while compiling - when executed, compiles
 ** code to fetch the value of a local given the local's index in the
-** word's pfa
+** word's pfa. The compiled (link), (unlink), (@local)... words are
+** opcodes run inline by the inner loop - see VM_OP_CASES_LOCALS in vm.c.
 **************************************************************************/
-static void getLocalParen(FICL_VM *pVM)
-{
-    FICL_INT nLocal = *(FICL_INT *)(pVM->ip++);
-    stackPush(pVM->pStack, pVM->rStack->pFrame[nLocal]);
-    return;
-}
-
-
-static void toLocalParen(FICL_VM *pVM)
-{
-    FICL_INT nLocal = *(FICL_INT *)(pVM->ip++);
-    pVM->rStack->pFrame[nLocal] = stackPop(pVM->pStack);
-    return;
-}
-
-
-static void getLocal0(FICL_VM *pVM)
-{
-    stackPush(pVM->pStack, pVM->rStack->pFrame[0]);
-    return;
-}
-
-
-static void toLocal0(FICL_VM *pVM)
-{
-    pVM->rStack->pFrame[0] = stackPop(pVM->pStack);
-    return;
-}
-
-
-static void getLocal1(FICL_VM *pVM)
-{
-    stackPush(pVM->pStack, pVM->rStack->pFrame[1]);
-    return;
-}
-
-
-static void toLocal1(FICL_VM *pVM)
-{
-    pVM->rStack->pFrame[1] = stackPop(pVM->pStack);
-    return;
-}
-
-
 /*
 ** Each local is recorded in a private locals dictionary as a
 ** word that does doLocalIm at runtime. DoLocalIm compiles code
@@ -3385,15 +3904,6 @@ static void localParen(FICL_VM *pVM)
 }
 
 
-static void get2LocalParen(FICL_VM *pVM)
-{
-    FICL_INT nLocal = *(FICL_INT *)(pVM->ip++);
-    stackPush(pVM->pStack, pVM->rStack->pFrame[nLocal]);
-    stackPush(pVM->pStack, pVM->rStack->pFrame[nLocal+1]);
-    return;
-}
-
-
 static void do2LocalIm(FICL_VM *pVM)
 {
     FICL_DICT *pDict = vmGetDict(pVM);
@@ -3413,15 +3923,6 @@ static void do2LocalIm(FICL_VM *pVM)
 }
 
 
-static void to2LocalParen(FICL_VM *pVM)
-{
-    FICL_INT nLocal = *(FICL_INT *)(pVM->ip++);
-    pVM->rStack->pFrame[nLocal+1] = stackPop(pVM->pStack);
-    pVM->rStack->pFrame[nLocal]   = stackPop(pVM->pStack);
-    return;
-}
-
-
 static void twoLocalParen(FICL_VM *pVM)
 {
     STRINGINFO si;
@@ -3443,27 +3944,6 @@ static void twoLocalParen(FICL_VM *pVM)
 
 
 #if FICL_WANT_FLOAT
-static void getFLocalParen(FICL_VM *pVM)
-{
-    FICL_INT nLocal = *(FICL_INT *)(pVM->ip++);
-    FICL_FLOAT f;
-
-    memcpy(&f, &pVM->rStack->pFrame[nLocal], sizeof(f));
-    PUSHFLOAT(f);
-    return;
-}
-
-
-static void toFLocalParen(FICL_VM *pVM)
-{
-    FICL_INT nLocal = *(FICL_INT *)(pVM->ip++);
-    FICL_FLOAT f = POPFLOAT();
-
-    memcpy(&pVM->rStack->pFrame[nLocal], &f, sizeof(f));
-    return;
-}
-
-
 static void doFLocalIm(FICL_VM *pVM)
 {
     FICL_DICT *pDict = vmGetDict(pVM);
@@ -3522,8 +4002,7 @@ static void fLocalParen(FICL_VM *pVM)
 static void compareInternal(FICL_VM *pVM, bool caseInsensitive)
 {
     const char *cp1, *cp2;
-    FICL_UNS u1, u2, uMin;
-    int n = 0;
+    FICL_UNS u1, u2;
 
     vmCheckStack(pVM, 4, 1);
     u2  = stackPopUNS(pVM->pStack);
@@ -3531,41 +4010,229 @@ static void compareInternal(FICL_VM *pVM, bool caseInsensitive)
     u1  = stackPopUNS(pVM->pStack);
     cp1 = (const char *)stackPopPtr(pVM->pStack);
 
-    uMin = (u1 < u2)? u1 : u2;
-    for ( ; (uMin > 0) && (n == 0); uMin--)
+    PUSHINT(ficlMemCompare(cp1, u1, cp2, u2, caseInsensitive));
+    return;
+}
+
+
+static void compareString(FICL_VM *pVM)
+{
+    compareInternal(pVM, false);
+}
+
+
+static void compareStringInsensitive(FICL_VM *pVM)
+{
+    compareInternal(pVM, true);
+}
+
+
+/**************************************************************************
+                        s e a r c h
+** STRING ( c-addr1 u1 c-addr2 u2 -- c-addr3 u3 flag )
+** Search the string specified by c-addr1 u1 for the string specified by
+** c-addr2 u2. If flag is true, a match was found at c-addr3 with u3
+** characters remaining. If flag is false there was no match and c-addr3
+** is c-addr1, and u3 is u1.
+**************************************************************************/
+static void searchString(FICL_VM *pVM)
+{
+    const char *cp1, *cp2, *match;
+    FICL_UNS u1, u2;
+
+    vmCheckStack(pVM, 4, 3);
+    u2  = stackPopUNS(pVM->pStack);
+    cp2 = (const char *)stackPopPtr(pVM->pStack);
+    u1  = stackPopUNS(pVM->pStack);
+    cp1 = (const char *)stackPopPtr(pVM->pStack);
+
+    match = ficlMemSearch(cp1, u1, cp2, u2);
+    if (match == NULL)
     {
-        char c1 = *cp1++;
-        char c2 = *cp2++;
-        if (caseInsensitive)
-        {
-            c1 = (char)tolower(c1);
-            c2 = (char)tolower(c2);
-        }
-        n = (int)(c1 - c2);
+        PUSHPTR((void *)cp1);
+        PUSHUNS(u1);
+        PUSHINT(FICL_FALSE);
+    }
+    else
+    {
+        PUSHPTR((void *)match);
+        PUSHUNS(u1 - (FICL_UNS)(match - cp1));
+        PUSHINT(FICL_TRUE);
     }
+    return;
+}
+
 
-    if (n == 0)
-        n = (int)(u1 - u2);
+/**************************************************************************
+                        s c a n   &   s k i p
+** Ficl ( c-addr1 u1 char -- c-addr2 u2 )
+** SCAN advances to the first occurrence of char, SKIP past leading
+** occurrences of char. c-addr2 u2 is what remains of the string; u2 is
+** zero if SCAN finds no char or SKIP finds nothing else.
+**************************************************************************/
+static void scan(FICL_VM *pVM)
+{
+    const char *cp, *found;
+    FICL_UNS u;
+    char ch;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 3, 2);
+#endif
+    ch = (char)POPINT();
+    u  = POPUNS();
+    cp = (const char *)POPPTR();
 
-    if (n < 0)
-        n = -1;
-    else if (n > 0)
-        n = 1;
+    found = (u > 0) ? memchr(cp, (unsigned char)ch, u) : NULL;
+    if (found == NULL)
+        found = cp + u;
 
-    PUSHINT(n);
+    PUSHPTR((void *)found);
+    PUSHUNS(u - (FICL_UNS)(found - cp));
     return;
 }
 
 
-static void compareString(FICL_VM *pVM)
+static void skip(FICL_VM *pVM)
 {
-    compareInternal(pVM, false);
+    const char *cp, *found;
+    FICL_UNS u;
+    char ch;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 3, 2);
+#endif
+    ch = (char)POPINT();
+    u  = POPUNS();
+    cp = (const char *)POPPTR();
+
+    found = ficlMemSkip(cp, u, ch);
+
+    PUSHPTR((void *)found);
+    PUSHUNS(u - (FICL_UNS)(found - cp));
+    return;
 }
 
 
-static void compareStringInsensitive(FICL_VM *pVM)
+/**************************************************************************
+                        c e l l   a r r a y s
+** Ficl words over u cells at a-addr (CREATE ... , tables or ALLOCATEd
+** blocks), one call per array rather than a DO ... LOOP per cell. See
+** the kernels in vm.c.
+**
+** cells-sum        ( a-addr u -- n )          wrapping sum
+** cells-min        ( a-addr u -- n index )    first smallest; 0 -1 if u is 0
+** cells-max        ( a-addr u -- n index )    first largest; 0 -1 if u is 0
+** cells-prefix-sum ( a-addr u -- )            in place running sum
+** cells-sort       ( a-addr u -- )            ascending, signed
+** cells-bsearch    ( a-addr u n -- index flag )
+**      index of the first cell not less than n in a sorted array, flag
+**      true if that cell is n
+** cells-histogram  ( a-addr1 u1 a-addr2 u2 -- u3 )
+**      add one to cell x of the u2 cell table at a-addr2 for each x of
+**      a-addr1 u1 in [0, u2); u3 counts the cells outside that range
+**************************************************************************/
+static void cellsSum(FICL_VM *pVM)
 {
-    compareInternal(pVM, true);
+    FICL_UNS u;
+    FICL_INT *p;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 2, 1);
+#endif
+    u = POPUNS();
+    p = (FICL_INT *)POPPTR();
+    PUSHINT(ficlCellSum(p, u));
+}
+
+
+static void cellsMinMax(FICL_VM *pVM, bool fMax)
+{
+    FICL_UNS u, index;
+    FICL_INT *p;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 2, 2);
+#endif
+    u = POPUNS();
+    p = (FICL_INT *)POPPTR();
+
+    if (u == 0)
+    {
+        PUSHINT(0);
+        PUSHINT(-1);
+        return;
+    }
+
+    index = ficlCellMinMax(p, u, fMax);
+    PUSHINT(p[index]);
+    PUSHUNS(index);
+}
+
+static void cellsMin(FICL_VM *pVM)
+{
+    cellsMinMax(pVM, false);
+}
+
+static void cellsMax(FICL_VM *pVM)
+{
+    cellsMinMax(pVM, true);
+}
+
+
+static void cellsPrefixSum(FICL_VM *pVM)
+{
+    FICL_UNS u;
+    FICL_INT *p;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 2, 0);
+#endif
+    u = POPUNS();
+    p = (FICL_INT *)POPPTR();
+    ficlCellPrefixSum(p, u);
+}
+
+
+static void cellsSort(FICL_VM *pVM)
+{
+    FICL_UNS u;
+    FICL_INT *p;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 2, 0);
+#endif
+    u = POPUNS();
+    p = (FICL_INT *)POPPTR();
+    ficlCellSort(p, u);
+}
+
+
+static void cellsBsearch(FICL_VM *pVM)
+{
+    FICL_UNS u, index;
+    FICL_INT *p;
+    FICL_INT n;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 3, 2);
+#endif
+    n = POPINT();
+    u = POPUNS();
+    p = (FICL_INT *)POPPTR();
+
+    index = ficlCellLowerBound(p, u, n);
+    PUSHUNS(index);
+    PUSHINT(((index < u) && (p[index] == n)) ? FICL_TRUE : FICL_FALSE);
+}
+
+
+static void cellsHistogram(FICL_VM *pVM)
+{
+    FICL_UNS u1, u2;
+    FICL_INT *p;
+    FICL_UNS *counts;
+#if FICL_ROBUST > 1
+    vmCheckStack(pVM, 4, 1);
+#endif
+    u2 = POPUNS();
+    counts = (FICL_UNS *)POPPTR();
+    u1 = POPUNS();
+    p = (FICL_INT *)POPPTR();
+    PUSHUNS(ficlCellHistogram(p, u1, counts, u2));
 }
 
 
@@ -3762,7 +4429,7 @@ static void ansAllocate(FICL_VM *pVM)
     void *p;
 
     size = stackPopUNS(pVM->pStack);
-    p = ficlMalloc(size);
+    p = ficlAllocate(pVM, size);
     PUSHPTR(p);
     if (p)
         PUSHINT(0);
@@ -3780,7 +4447,7 @@ static void ansFree(FICL_VM *pVM)
     void *p;
 
     p = stackPopPtr(pVM->pStack);
-    ficlFree(p);
+    ficlAllocFree(pVM, p);
     PUSHINT(0);
 }
 
@@ -3796,7 +4463,7 @@ static void ansResize(FICL_VM *pVM)
 
     size = stackPopUNS(pVM->pStack);
     old = stackPopPtr(pVM->pStack);
-    new_ = ficlRealloc(old, size);
+    new_ = ficlAllocResize(pVM, old, size);
     if (new_)
     {
         PUSHPTR(new_);
@@ -3875,6 +4542,13 @@ WORDKIND ficlWordClassify(FICL_WORD *pFW)
     case FICL_OP_VARIABLE:   return VARIABLE;
     case FICL_OP_STRINGLIT:  return STRINGLIT;
     case FICL_OP_CSTRINGLIT: return CSTRINGLIT;
+#if FICL_WANT_OOP
+    case FICL_OP_METHOD:     return METHOD;
+    case FICL_OP_METHOD_XT:  return METHOD;
+#if FICL_WANT_VCALL
+    case FICL_OP_VCALL:      return VCALL;
+#endif
+#endif
 #if FICL_WANT_USER
     case FICL_OP_USER:       return USER;
 #endif
@@ -4007,6 +4681,7 @@ void ficlCompileCore(FICL_SYSTEM *pSys)
     dictAppendOpWord(dp, "c@",        FICL_OP_C_FETCH,  FW_DEFAULT);
     dictAppendWord(  dp, "case",      caseCoIm,       FW_COMPIMMED);
     dictAppendWord(  dp, "cell+",     cellPlus,       FW_DEFAULT);
+    pSys->pCells =
     dictAppendWord(  dp, "cells",     cells,          FW_DEFAULT);
     dictAppendWord(  dp, "char",      ficlChar,       FW_DEFAULT);
     dictAppendWord(  dp, "char+",     charPlus,       FW_DEFAULT);
@@ -4032,15 +4707,16 @@ void ficlCompileCore(FICL_SYSTEM *pSys)
     dictAppendWord(  dp, "fallthrough",fallthroughCoIm,FW_COMPIMMED);
     dictAppendWord(  dp, "fill",      fill,           FW_DEFAULT);
     dictAppendWord(  dp, "find",      cFind,          FW_DEFAULT);
+    dictAppendWord(  dp, "flush-output", flushOutput, FW_DEFAULT);
     dictAppendWord(  dp, "fm/mod",    fmSlashMod,     FW_DEFAULT);
     dictAppendWord(  dp, "here",      here,           FW_DEFAULT);
     dictAppendWord(  dp, "hold",      hold,           FW_DEFAULT);
-    dictAppendWord(  dp, "i",         loopICo,        FW_COMPILE);
+    dictAppendOpWord(dp, "i",         FICL_OP_LOOP_I, FW_COMPILE);
     dictAppendWord(  dp, "if",        ifCoIm,         FW_COMPIMMED);
     dictAppendWord(  dp, "immediate", immediate,      FW_DEFAULT);
     dictAppendOpWord(dp, "invert",    FICL_OP_INVERT,  FW_DEFAULT);
-    dictAppendWord(  dp, "j",         loopJCo,        FW_COMPILE);
-    dictAppendWord(  dp, "k",         loopKCo,        FW_COMPILE);
+    dictAppendOpWord(dp, "j",         FICL_OP_LOOP_J, FW_COMPILE);
+    dictAppendOpWord(dp, "k",         FICL_OP_LOOP_K, FW_COMPILE);
     dictAppendOpWord(dp, "leave",     FICL_OP_LEAVE,  FW_COMPILE);
     dictAppendWord(  dp, "literal",   literalIm,      FW_IMMEDIATE);
     dictAppendWord(  dp, "loop",      loopCoIm,       FW_COMPIMMED);
@@ -4100,6 +4776,7 @@ void ficlCompileCore(FICL_SYSTEM *pSys)
     dictAppendWord(  dp, "?do",       qDoCoIm,        FW_COMPIMMED);
     dictAppendWord(  dp, "again",     againCoIm,      FW_COMPIMMED);
     dictAppendWord(  dp, "c\"",       cstringQuoteIm, FW_IMMEDIATE);
+    dictAppendWord(  dp, "erase",     erase,          FW_DEFAULT);
     dictAppendWord(  dp, "hex",       hex,            FW_DEFAULT);
     dictAppendWord(  dp, "pad",       pad,            FW_DEFAULT);
     dictAppendWord(  dp, "parse",     parse,          FW_DEFAULT);
@@ -4157,35 +4834,35 @@ void ficlCompileCore(FICL_SYSTEM *pSys)
     */
 #if FICL_WANT_LOCALS
     pSys->pLinkParen =
-    dictAppendWord(  dp, "(link)",    linkParen,      FW_COMPILE);
+    dictAppendOpWord(dp, "(link)",    FICL_OP_LINK,   FW_COMPILE);
     pSys->pUnLinkParen =
-    dictAppendWord(  dp, "(unlink)",  unlinkParen,    FW_COMPILE);
+    dictAppendOpWord(dp, "(unlink)",  FICL_OP_UNLINK, FW_COMPILE);
     dictAppendWord(  dp, "doLocal",   doLocalIm,      FW_COMPIMMED);
     pSys->pGetLocalParen =
-    dictAppendWord(  dp, "(@local)",  getLocalParen,  FW_COMPILE);
+    dictAppendOpWord(dp, "(@local)",  FICL_OP_GET_LOCAL,  FW_COMPILE);
     pSys->pToLocalParen =
-    dictAppendWord(  dp, "(toLocal)", toLocalParen,   FW_COMPILE);
+    dictAppendOpWord(dp, "(toLocal)", FICL_OP_TO_LOCAL,   FW_COMPILE);
     pSys->pGetLocal0 =
-    dictAppendWord(  dp, "(@local0)", getLocal0,      FW_COMPILE);
+    dictAppendOpWord(dp, "(@local0)", FICL_OP_GET_LOCAL0, FW_COMPILE);
     pSys->pToLocal0 =
-    dictAppendWord(  dp, "(toLocal0)",toLocal0,       FW_COMPILE);
+    dictAppendOpWord(dp, "(toLocal0)",FICL_OP_TO_LOCAL0,  FW_COMPILE);
     pSys->pGetLocal1 =
-    dictAppendWord(  dp, "(@local1)", getLocal1,      FW_COMPILE);
+    dictAppendOpWord(dp, "(@local1)", FICL_OP_GET_LOCAL1, FW_COMPILE);
     pSys->pToLocal1 =
-    dictAppendWord(  dp, "(toLocal1)",toLocal1,       FW_COMPILE);
+    dictAppendOpWord(dp, "(toLocal1)",FICL_OP_TO_LOCAL1,  FW_COMPILE);
     dictAppendWord(  dp, "(local)",   localParen,     FW_COMPILE);
 
     pSys->pGet2LocalParen =
-    dictAppendWord(  dp, "(@2local)", get2LocalParen, FW_COMPILE);
+    dictAppendOpWord(dp, "(@2local)", FICL_OP_GET_2LOCAL, FW_COMPILE);
     pSys->pTo2LocalParen =
-    dictAppendWord(  dp, "(to2Local)",to2LocalParen,  FW_COMPILE);
+    dictAppendOpWord(dp, "(to2Local)",FICL_OP_TO_2LOCAL,  FW_COMPILE);
     dictAppendWord(  dp, "(2local)",  twoLocalParen,  FW_COMPILE);
 
 #if FICL_WANT_FLOAT
     pSys->pGetFLocalParen =
-    dictAppendWord(  dp, "(@flocal)", getFLocalParen, FW_COMPILE);
+    dictAppendOpWord(dp, "(@flocal)", FICL_OP_GET_FLOCAL, FW_COMPILE);
     pSys->pToFLocalParen =
-    dictAppendWord(  dp, "(toFLocal)",toFLocalParen,  FW_COMPILE);
+    dictAppendOpWord(dp, "(toFLocal)",FICL_OP_TO_FLOCAL,  FW_COMPILE);
     dictAppendWord(  dp, "(flocal)",  fLocalParen,    FW_COMPILE);
 #endif
 
@@ -4203,6 +4880,7 @@ void ficlCompileCore(FICL_SYSTEM *pSys)
     dictAppendWord(  dp, "resize",    ansResize,      FW_DEFAULT);
 
     ficlSetEnv(pSys, "memory-alloc",      FICL_TRUE);
+    ficlCompileHeap(pSys);   /* heap statistics - see heap.c */
 
     /*
     ** optional SEARCH-ORDER word set
@@ -4234,8 +4912,17 @@ void ficlCompileCore(FICL_SYSTEM *pSys)
     dictAppendWord(  dp, "add-parse-step",
                                       addParseStep,   FW_DEFAULT);
     dictAppendWord(  dp, "body>",     fromBody,       FW_DEFAULT);
+    dictAppendWord(  dp, "cells-bsearch",  cellsBsearch,   FW_DEFAULT);
+    dictAppendWord(  dp, "cells-histogram", cellsHistogram, FW_DEFAULT);
+    dictAppendWord(  dp, "cells-max", cellsMax,       FW_DEFAULT);
+    dictAppendWord(  dp, "cells-min", cellsMin,       FW_DEFAULT);
+    dictAppendWord(  dp, "cells-prefix-sum", cellsPrefixSum, FW_DEFAULT);
+    dictAppendWord(  dp, "cells-sort", cellsSort,     FW_DEFAULT);
+    dictAppendWord(  dp, "cells-sum", cellsSum,       FW_DEFAULT);
     dictAppendWord(  dp, "compare",   compareString,  FW_DEFAULT);   /* STRING */
     dictAppendWord(  dp, "compare-insensitive",   compareStringInsensitive,  FW_DEFAULT);   /* STRING */
+    dictAppendWord(  dp, "cmove",     cmove,          FW_DEFAULT);   /* STRING */
+    dictAppendWord(  dp, "cmove>",    cmoveUp,        FW_DEFAULT);   /* STRING */
     dictAppendWord(  dp, "compile-only",
                                       compileOnly,    FW_DEFAULT);
     dictAppendWord(  dp, "endif",     endifCoIm,      FW_COMPIMMED);
@@ -4243,7 +4930,36 @@ void ficlCompileCore(FICL_SYSTEM *pSys)
     dictAppendWord(  dp, "hash",      hash,           FW_DEFAULT);
     dictAppendWord(  dp, "objectify", setObjectFlag,  FW_DEFAULT);
     dictAppendWord(  dp, "?object",   isObject,       FW_DEFAULT);
+#if FICL_WANT_OOP
+#if FICL_WANT_VCALL
+    pSys->pMethodParen =
+#endif
+    dictAppendOpWord(dp, "(-->)",     FICL_OP_METHOD, FW_COMPILE);
+    dictAppendOpWord(dp, "(c->)",     FICL_OP_METHOD_XT, FW_COMPILE);
+    dictAppendWord(  dp, "(method)",  methodParen,    FW_DEFAULT);
+    dictAppendWord(  dp, "method-cache,", methodCacheComma, FW_DEFAULT);
+    dictAppendWord(  dp, "method-call,", methodCallComma, FW_DEFAULT);
+    dictAppendWord(  dp, "(instance-var)", instanceVarParen, FW_DEFAULT);
+    dictAppendWord(  dp, "(aggregate)", aggregateParen, FW_DEFAULT);
+    dictAppendWord(  dp, "(ref)",     refParen,       FW_DEFAULT);
+    dictAppendWord(  dp, "(index)",   indexParen,     FW_DEFAULT);
+    dictAppendWord(  dp, "(next)",    nextParen,      FW_DEFAULT);
+    dictAppendWord(  dp, "(prev)",    prevParen,      FW_DEFAULT);
+    dictAppendWord(  dp, "(init)",    initParen,      FW_DEFAULT);
+    dictAppendWord(  dp, "(alloc)",   allocParen,     FW_DEFAULT);
+#if FICL_WANT_VCALL
+    pSys->pVcallParen =
+    dictAppendOpWord(dp, "(vcall)",   FICL_OP_VCALL,  FW_COMPILE);
+    dictAppendWord(  dp, "build-vtable", buildVtable, FW_DEFAULT);
+    dictAppendWord(  dp, "vtable-slot", vtableSlotWord, FW_DEFAULT);
+    dictAppendWord(  dp, "vcall",     vcall,          FW_DEFAULT);
+    dictAppendWord(  dp, "vcall,",    vcallComma,     FW_DEFAULT);
+#endif
+#endif
+    dictAppendWord(  dp, "scan",      scan,           FW_DEFAULT);
+    dictAppendWord(  dp, "search",    searchString,   FW_DEFAULT);   /* STRING */
     dictAppendWord(  dp, "sfind",     sFind,          FW_DEFAULT);
+    dictAppendWord(  dp, "skip",      skip,           FW_DEFAULT);
     dictAppendWord(  dp, "sliteral",  sLiteralCoIm,   FW_COMPIMMED); /* STRING */
     dictAppendWord(  dp, "sprintf",   ficlSprintf,    FW_DEFAULT);
     dictAppendWord(  dp, "strlen",    ficlStrlen,     FW_DEFAULT);
@@ -4289,6 +5005,12 @@ void ficlCompileCore(FICL_SYSTEM *pSys)
     dictAppendOpWord(dp, "(?do)",     FICL_OP_QDO,    FW_COMPILE);
     pSys->pLoopParen =
     dictAppendOpWord(dp, "(loop)",    FICL_OP_LOOP,   FW_COMPILE);
+    pSys->pIPlus =
+    dictAppendOpWord(dp, "(i+)",      FICL_OP_I_PLUS, FW_COMPILE);
+    pSys->pICells =
+    dictAppendOpWord(dp, "(icells)",  FICL_OP_I_CELLS, FW_COMPILE);
+    pSys->pICellsPlus =
+    dictAppendOpWord(dp, "(icells+)", FICL_OP_I_CELLS_PLUS, FW_COMPILE);
     pSys->pPLoopParen =
     dictAppendOpWord(dp, "(+loop)",   FICL_OP_PLOOP,  FW_COMPILE);
     pSys->pInterpret =